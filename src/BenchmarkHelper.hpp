@@ -0,0 +1,45 @@
+//
+// (c)2019 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+#pragma once
+
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+
+namespace lr::test {
+
+
+/// Measure the time of a benchmark function and print the operations per second.
+/// The function returns a checksum of its results, which is printed to make sure
+/// the compiler does not remove the measured work.
+///
+template<typename Function>
+void measure(const std::string &name, double operationCount, const char *unit, Function function)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+    const auto checksum = function();
+    const auto endTime = std::chrono::steady_clock::now();
+    const std::chrono::duration<double> duration = endTime - startTime;
+    std::cout << name << ": " << (operationCount / duration.count()) << " " << unit << "/s (" << +checksum << ")" << std::endl;
+}
+
+
+}
+
@@ -15,12 +15,20 @@
 // with this program; if not, write to the Free Software Foundation, Inc.,
 // 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 //
+#include "BenchmarkHelper.hpp"
+#include "DateTimeTestHelper.hpp"
+
 #include "hal-common/DateTime.hpp"
 
 #include "gtest/gtest.h"
 
+#include <cstdio>
+#include <cstring>
 #include <ctime>
 #include <iostream>
+#include <random>
+#include <string>
+#include <vector>
 
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "cert-err58-cpp"
@@ -28,6 +36,8 @@
 
 
 using lr::DateTime;
+using lr::test::createRandomDateTime;
+using lr::test::measure;
 
 
 /// Test the state of a date/time object after construction.
@@ -416,4 +426,511 @@ TEST(DateTimeTest, StringConversion)
 }
 
 
+/// Test the construction of date/time values at compile time.
+///
+TEST(DateTimeTest, ConstexprConstruction)
+{
+    constexpr DateTime first;
+    static_assert(first.isFirst(), "Expected the first date/time.");
+    static_assert(first.getYear() == 2000, "Unexpected year.");
+    static_assert(first.getMonth() == 1, "Unexpected month.");
+    static_assert(first.getDay() == 1, "Unexpected day.");
+
+    constexpr DateTime custom(2019, 4, 11, 12, 21, 13);
+    static_assert(!custom.isFirst(), "Unexpected first date/time.");
+    static_assert(custom.getYear() == 2019, "Unexpected year.");
+    static_assert(custom.getMonth() == 4, "Unexpected month.");
+    static_assert(custom.getDay() == 11, "Unexpected day.");
+    static_assert(custom.getHour() == 12, "Unexpected hour.");
+    static_assert(custom.getMinute() == 21, "Unexpected minute.");
+    static_assert(custom.getSecond() == 13, "Unexpected second.");
+
+    // The same limits as in the `ConstructionLimits` test.
+    constexpr DateTime low(0, 0, 0, 0, 0, 0);
+    static_assert(low.getYear() == 2000, "Unexpected year.");
+    static_assert(low.getMonth() == 1, "Unexpected month.");
+    static_assert(low.getDay() == 1, "Unexpected day.");
+    static_assert(low.getHour() == 0, "Unexpected hour.");
+    static_assert(low.getMinute() == 0, "Unexpected minute.");
+    static_assert(low.getSecond() == 0, "Unexpected second.");
+    constexpr DateTime high(0xffffu, 0xffu, 0xffu, 0xffu, 0xffu, 0xffu);
+    static_assert(high.getYear() == 9999, "Unexpected year.");
+    static_assert(high.getMonth() == 12, "Unexpected month.");
+    static_assert(high.getDay() == 31, "Unexpected day.");
+    static_assert(high.getHour() == 23, "Unexpected hour.");
+    static_assert(high.getMinute() == 59, "Unexpected minute.");
+    static_assert(high.getSecond() == 59, "Unexpected second.");
+
+    // The compile time values have to match the runtime values.
+    const DateTime runtimeCustom(2019, 4, 11, 12, 21, 13);
+    EXPECT_EQ(runtimeCustom, custom);
+}
+
+
+/// Test the day of week calculation at compile time.
+///
+TEST(DateTimeTest, ConstexprDayOfWeek)
+{
+    static_assert(DateTime(2000, 1, 1).getDayOfWeek() == 6, "Expected a saturday.");
+    static_assert(DateTime(2019, 1, 1).getDayOfWeek() == 2, "Expected a tuesday.");
+    static_assert(DateTime(2019, 4, 11).getDayOfWeek() == 4, "Expected a thursday.");
+    static_assert(DateTime(2019, 6, 30).getDayOfWeek() == 0, "Expected a sunday.");
+    static_assert(DateTime(2020, 2, 29).getDayOfWeek() == 6, "Expected a saturday.");
+    static_assert(DateTime(2100, 3, 1).getDayOfWeek() == 1, "Expected a monday.");
+}
+
+
+/// Test parsing date/time values from strings.
+/// Fields which are not part of the format are set to the first date/time.
+///
+TEST(DateTimeTest, FromString)
+{
+    struct TestValue {
+        DateTime::Format format;
+        const char* text;
+        DateTime expected;
+    };
+    TestValue testValues[] = {
+        TestValue({DateTime::Format::ISO, "2019-04-11T12:21:13", DateTime(2019, 4, 11, 12, 21, 13)}),
+        TestValue({DateTime::Format::Long, "2019-04-11 12:21:13", DateTime(2019, 4, 11, 12, 21, 13)}),
+        TestValue({DateTime::Format::ISODate, "2019-04-11", DateTime(2019, 4, 11, 0, 0, 0)}),
+        TestValue({DateTime::Format::ISOBasicDate, "20190411", DateTime(2019, 4, 11, 0, 0, 0)}),
+        TestValue({DateTime::Format::ISOTime, "12:21:13", DateTime(2000, 1, 1, 12, 21, 13)}),
+        TestValue({DateTime::Format::ISOBasicTime, "122113", DateTime(2000, 1, 1, 12, 21, 13)}),
+        TestValue({DateTime::Format::ShortDate, "11.04.", DateTime(2000, 4, 11, 0, 0, 0)}),
+        TestValue({DateTime::Format::ShortTime, "12:21", DateTime(2000, 1, 1, 12, 21, 0)}),
+        TestValue({DateTime::Format::ISO, "2000-01-01T00:00:00", DateTime()}),
+        TestValue({DateTime::Format::ISO, "9999-12-31T23:59:59", DateTime(9999, 12, 31, 23, 59, 59)}),
+        TestValue({DateTime::Format::ISODate, "2020-02-29", DateTime(2020, 2, 29, 0, 0, 0)}),
+    };
+    for (const auto &testValue : testValues) {
+        SCOPED_TRACE(testValue.text);
+        const auto result = DateTime::fromString(testValue.text, testValue.format);
+        ASSERT_EQ(true, result.isSuccess());
+        ASSERT_EQ(testValue.expected, result.getValue());
+        const auto resultFromString = DateTime::fromString(lr::String(testValue.text), testValue.format);
+        ASSERT_EQ(true, resultFromString.isSuccess());
+        ASSERT_EQ(testValue.expected, resultFromString.getValue());
+    }
+}
+
+
+/// Test if invalid strings are rejected.
+///
+TEST(DateTimeTest, FromStringInvalid)
+{
+    struct TestValue {
+        DateTime::Format format;
+        const char* text;
+    };
+    TestValue testValues[] = {
+        TestValue({DateTime::Format::ISO, ""}),
+        TestValue({DateTime::Format::ISO, "2019-04-11"}),
+        TestValue({DateTime::Format::ISO, "2019-04-11T12:21:1"}),
+        TestValue({DateTime::Format::ISO, "2019-04-11T12:21:130"}),
+        TestValue({DateTime::Format::ISO, "2019-04-11 12:21:13"}),
+        TestValue({DateTime::Format::ISO, "2019/04/11T12:21:13"}),
+        TestValue({DateTime::Format::ISO, "2019-04-11T12:21:1x"}),
+        TestValue({DateTime::Format::ISO, " 2019-04-11T12:21:13"}),
+        TestValue({DateTime::Format::ISO, "2019-4-11T12:21:13 "}),
+        TestValue({DateTime::Format::ISO, "1999-12-31T23:59:59"}),
+        TestValue({DateTime::Format::ISO, "2019-00-11T12:21:13"}),
+        TestValue({DateTime::Format::ISO, "2019-13-11T12:21:13"}),
+        TestValue({DateTime::Format::ISO, "2019-04-00T12:21:13"}),
+        TestValue({DateTime::Format::ISO, "2019-04-31T12:21:13"}),
+        TestValue({DateTime::Format::ISO, "2019-02-29T12:21:13"}),
+        TestValue({DateTime::Format::ISO, "2100-02-29T12:21:13"}),
+        TestValue({DateTime::Format::ISO, "2019-04-11T24:00:00"}),
+        TestValue({DateTime::Format::ISO, "2019-04-11T12:60:00"}),
+        TestValue({DateTime::Format::ISO, "2019-04-11T12:21:60"}),
+        TestValue({DateTime::Format::Long, "2019-04-11T12:21:13"}),
+        TestValue({DateTime::Format::ISODate, "20190411"}),
+        TestValue({DateTime::Format::ISOBasicDate, "2019-04-11"}),
+        TestValue({DateTime::Format::ISOBasicDate, "2019041"}),
+        TestValue({DateTime::Format::ISOTime, "122113"}),
+        TestValue({DateTime::Format::ISOBasicTime, "12:21:13"}),
+        TestValue({DateTime::Format::ShortDate, "11.04"}),
+        TestValue({DateTime::Format::ShortDate, "31.04."}),
+        TestValue({DateTime::Format::ShortTime, "12:21:13"}),
+        TestValue({DateTime::Format::ShortTime, "-1:21"}),
+    };
+    for (const auto &testValue : testValues) {
+        SCOPED_TRACE(testValue.text);
+        const auto result = DateTime::fromString(testValue.text, testValue.format);
+        ASSERT_EQ(true, result.hasError());
+    }
+}
+
+
+/// Convert random date/time values to strings and parse them again.
+///
+TEST(DateTimeTest, FromStringRoundTrip)
+{
+    std::ranlux24_base engine(0x56); // Fixed value for the tests.
+    const DateTime::Format formats[] = {DateTime::Format::ISO, DateTime::Format::Long};
+    for (int i = 0; i < 10000; ++i) {
+        const DateTime dateTime = createRandomDateTime(engine);
+        for (const auto format : formats) {
+            const auto text = dateTime.toString(format);
+            SCOPED_TRACE(text.getData());
+            const auto result = DateTime::fromString(text, format);
+            ASSERT_EQ(true, result.isSuccess());
+            ASSERT_EQ(dateTime, result.getValue());
+        }
+    }
+}
+
+
+/// Test parsing a buffer with newline separated date/time values.
+///
+TEST(DateTimeTest, FromStringLines)
+{
+    const std::string text =
+        "2019-04-11T12:21:13\n"
+        "2019-04-11T12:21:14\n"
+        "2020-02-29T00:00:00\n"
+        "9999-12-31T23:59:59\n";
+    DateTime dateTimes[8];
+    auto result = DateTime::fromStringLines(text.data(), text.size(), DateTime::Format::ISO, dateTimes, 8);
+    ASSERT_EQ(true, result.isSuccess());
+    ASSERT_EQ(4, result.getValue());
+    EXPECT_EQ(DateTime(2019, 4, 11, 12, 21, 13), dateTimes[0]);
+    EXPECT_EQ(DateTime(2019, 4, 11, 12, 21, 14), dateTimes[1]);
+    EXPECT_EQ(DateTime(2020, 2, 29, 0, 0, 0), dateTimes[2]);
+    EXPECT_EQ(DateTime(9999, 12, 31, 23, 59, 59), dateTimes[3]);
+    // The last line does not need a newline.
+    result = DateTime::fromStringLines(text.data(), text.size() - 1, DateTime::Format::ISO, dateTimes, 8);
+    ASSERT_EQ(true, result.isSuccess());
+    ASSERT_EQ(4, result.getValue());
+    EXPECT_EQ(DateTime(9999, 12, 31, 23, 59, 59), dateTimes[3]);
+    // Only parse up to the maximum count.
+    result = DateTime::fromStringLines(text.data(), text.size(), DateTime::Format::ISO, dateTimes, 2);
+    ASSERT_EQ(true, result.isSuccess());
+    ASSERT_EQ(2, result.getValue());
+    // An empty buffer.
+    result = DateTime::fromStringLines(text.data(), 0, DateTime::Format::ISO, dateTimes, 8);
+    ASSERT_EQ(true, result.isSuccess());
+    ASSERT_EQ(0, result.getValue());
+    // Any invalid line is an error.
+    const std::string invalidText =
+        "2019-04-11T12:21:13\n"
+        "2019-04-11 12:21:14\n";
+    result = DateTime::fromStringLines(invalidText.data(), invalidText.size(), DateTime::Format::ISO, dateTimes, 8);
+    ASSERT_EQ(true, result.hasError());
+    // Other formats.
+    const std::string dateText = "20190411\n20190412\n";
+    result = DateTime::fromStringLines(dateText.data(), dateText.size(), DateTime::Format::ISOBasicDate, dateTimes, 8);
+    ASSERT_EQ(true, result.isSuccess());
+    ASSERT_EQ(2, result.getValue());
+    EXPECT_EQ(DateTime(2019, 4, 11), dateTimes[0]);
+    EXPECT_EQ(DateTime(2019, 4, 12), dateTimes[1]);
+}
+
+
+/// Compare the speed of the parser with `sscanf`.
+///
+TEST(DateTimeTest, DISABLED_BenchmarkFromString)
+{
+    const int lineCount = 0x100000;
+    std::string text;
+    text.reserve(lineCount * 20);
+    for (int i = 0; i < lineCount; ++i) {
+        text.append(DateTime(2019, 1 + i % 12, 1 + i % 28, i % 24, i % 60, (i / 60) % 60).toString(DateTime::Format::ISO).getData());
+        text.append("\n");
+    }
+    std::vector<DateTime> dateTimes(lineCount);
+    bool isSuccess = false;
+    std::size_t parsedCount = 0;
+    measure("fromStringLines()", lineCount, "lines", [&]() {
+        const auto result = DateTime::fromStringLines(text.data(), text.size(), DateTime::Format::ISO, dateTimes.data(), lineCount);
+        isSuccess = result.isSuccess();
+        parsedCount = result.getValue();
+        return parsedCount;
+    });
+    ASSERT_EQ(true, isSuccess);
+    ASSERT_EQ(lineCount, parsedCount);
+    measure("sscanf()", lineCount, "lines", [&]() {
+        int checksum = 0;
+        for (int i = 0; i < lineCount; ++i) {
+            // Copy each line, `sscanf` may determine the length of the whole input.
+            char line[20];
+            std::memcpy(line, text.data() + i * 20, 19);
+            line[19] = '\0';
+            unsigned year, month, day, hour, minute, second;
+            checksum += std::sscanf(line, "%4u-%2u-%2uT%2u:%2u:%2u", &year, &month, &day, &hour, &minute, &second);
+            dateTimes[i] = DateTime(year, month, day, hour, minute, second);
+        }
+        return checksum;
+    });
+}
+
+
+namespace {
+
+
+/// All formats for the string conversion tests.
+///
+const DateTime::Format cAllFormats[] = {
+    DateTime::Format::ISO,
+    DateTime::Format::Long,
+    DateTime::Format::ISODate,
+    DateTime::Format::ISOBasicDate,
+    DateTime::Format::ISOTime,
+    DateTime::Format::ISOBasicTime,
+    DateTime::Format::ShortDate,
+    DateTime::Format::ShortTime,
+};
+
+
+}
+
+
+/// Test the string conversion into a caller provided buffer.
+/// The result has to match the result of `toString(format)`.
+///
+TEST(DateTimeTest, StringConversionToBuffer)
+{
+    std::ranlux24_base engine(0x56); // Fixed value for the tests.
+    char buffer[32];
+    for (int i = 0; i < 1000; ++i) {
+        const DateTime dateTime = createRandomDateTime(engine);
+        for (const auto format : cAllFormats) {
+            const auto expected = dateTime.toString(format);
+            SCOPED_TRACE(expected.getData());
+            std::memset(buffer, 'x', sizeof(buffer));
+            const auto length = dateTime.toString(buffer, sizeof(buffer), format);
+            ASSERT_EQ(expected.getLength(), length);
+            ASSERT_EQ(0, std::strcmp(expected.getData(), buffer));
+        }
+    }
+}
+
+
+/// Test the string conversion into buffers which are too small.
+///
+TEST(DateTimeTest, StringConversionBufferLimits)
+{
+    const DateTime custom(2019, 4, 11, 12, 21, 13);
+    char buffer[32];
+    for (const auto format : cAllFormats) {
+        const auto expected = custom.toString(format);
+        SCOPED_TRACE(expected.getData());
+        // The exact size, including the terminating zero.
+        std::memset(buffer, 'x', sizeof(buffer));
+        auto length = custom.toString(buffer, expected.getLength() + 1, format);
+        ASSERT_EQ(expected.getLength(), length);
+        ASSERT_EQ(0, std::strcmp(expected.getData(), buffer));
+        // One byte too small results in an empty string.
+        std::memset(buffer, 'x', sizeof(buffer));
+        length = custom.toString(buffer, expected.getLength(), format);
+        ASSERT_EQ(0, length);
+        ASSERT_EQ('\0', buffer[0]);
+        ASSERT_EQ('x', buffer[expected.getLength()]);
+        // Nothing is written to a zero size buffer.
+        std::memset(buffer, 'x', sizeof(buffer));
+        length = custom.toString(buffer, 0, format);
+        ASSERT_EQ(0, length);
+        ASSERT_EQ('x', buffer[0]);
+    }
+}
+
+
+/// Test appending the string conversion to an existing string.
+///
+TEST(DateTimeTest, StringConversionAppend)
+{
+    const DateTime custom(2019, 4, 11, 12, 21, 13);
+    lr::String text("Time: ");
+    custom.appendToString(text, DateTime::Format::ISO);
+    EXPECT_EQ(text, "Time: 2019-04-11T12:21:13");
+    text.append(", ");
+    custom.appendToString(text, DateTime::Format::ShortTime);
+    EXPECT_EQ(text, "Time: 2019-04-11T12:21:13, 12:21");
+    lr::String empty;
+    custom.appendToString(empty, DateTime::Format::ISOBasicDate);
+    EXPECT_EQ(empty, "20190411");
+}
+
+
+/// Compare the speed of the string conversions for all formats.
+///
+TEST(DateTimeTest, DISABLED_BenchmarkToString)
+{
+    const int iterations = 0x100000;
+    const DateTime custom(2019, 4, 11, 12, 21, 13);
+    char buffer[32];
+    for (const auto format : cAllFormats) {
+        const std::string formatText = custom.toString(format).getData();
+        measure(formatText + " toString(format)", iterations, "conversions", [&]() {
+            std::size_t checksum = 0;
+            for (int i = 0; i < iterations; ++i) {
+                checksum += custom.toString(format).getLength();
+            }
+            return checksum;
+        });
+        measure(formatText + " toString(buffer)", iterations, "conversions", [&]() {
+            std::size_t checksum = 0;
+            for (int i = 0; i < iterations; ++i) {
+                checksum += custom.toString(buffer, sizeof(buffer), format);
+            }
+            return checksum;
+        });
+    }
+}
+
+
+/// Test counting seconds using `addSeconds()`.
+///
+TEST(DateTimeTest, AddSecondsCount)
+{
+    // Setting the timezone to UTC to make sure `mktime` will convert the `std::tm` as UTC.
+    setenv("TZ", "UTC", 1);
+    std::tm startDate = {
+        .tm_year = (2019-1900), // Years are counted from 1900
+        .tm_mon = 8-1, // Month 0-11
+        .tm_mday = 1, // Day 1-31
+        .tm_hour = 0,
+        .tm_min = 0,
+        .tm_sec = 0
+    };
+    std::tm testEndDate = {
+        .tm_year = (2020-1900),
+        .tm_mon = 8-1,
+        .tm_mday = 1,
+        .tm_hour = 0,
+        .tm_min = 0,
+        .tm_sec = 0
+    };
+    std::tm currentDate = {};
+    const std::time_t testEndTime = std::mktime(&testEndDate);
+    const int stepSizes[] = {27, 59, 60, 61, 3599, 3600, 86399};
+    for (const auto stepSize : stepSizes) {
+        SCOPED_TRACE(std::string("Step size: ") + std::to_string(stepSize));
+        std::time_t currentTime = std::mktime(&startDate);
+        DateTime dateTime(2019, 8, 1, 0, 0, 0);
+        while (currentTime < testEndTime) {
+            gmtime_r(&currentTime, &currentDate);
+            ASSERT_EQ(currentDate.tm_year + 1900, dateTime.getYear());
+            ASSERT_EQ(currentDate.tm_mon + 1, dateTime.getMonth());
+            ASSERT_EQ(currentDate.tm_mday, dateTime.getDay());
+            ASSERT_EQ(currentDate.tm_hour, dateTime.getHour());
+            ASSERT_EQ(currentDate.tm_min, dateTime.getMinute());
+            ASSERT_EQ(currentDate.tm_sec, dateTime.getSecond());
+            currentTime += stepSize;
+            dateTime.addSeconds(stepSize);
+        }
+    }
+}
+
+
+namespace {
+
+
+/// Helper method to convert a date/time into a unix time.
+///
+std::time_t dateTimeToUnixTime(const DateTime &dateTime)
+{
+    // Setting the timezone to UTC to make sure `mktime` will convert the `std::tm` as UTC.
+    setenv("TZ", "UTC", 1);
+    std::tm date = {};
+    date.tm_year = dateTime.getYear() - 1900;
+    date.tm_mon = dateTime.getMonth() - 1;
+    date.tm_mday = dateTime.getDay();
+    date.tm_hour = dateTime.getHour();
+    date.tm_min = dateTime.getMinute();
+    date.tm_sec = dateTime.getSecond();
+    return std::mktime(&date);
+}
+
+
+}
+
+
+/// Test adding random seconds, minutes and days, also negative values.
+///
+TEST(DateTimeTest, AddRandomIntervals)
+{
+    static_assert(sizeof(std::time_t) >= 8, "This test requires 64bit time_t.");
+    const std::time_t firstTime = dateTimeToUnixTime(DateTime(2000, 1, 1, 0, 0, 0));
+    const std::time_t lastTime = dateTimeToUnixTime(DateTime(9999, 12, 31, 23, 59, 59));
+    std::ranlux24_base engine(0x56); // Fixed value for the tests.
+    std::uniform_int_distribution<std::time_t> timeDistribution(firstTime, lastTime);
+    std::uniform_int_distribution<int32_t> secondsDistribution;
+    std::uniform_int_distribution<int32_t> minutesDistribution(-0x1000000, 0x1000000);
+    std::uniform_int_distribution<int32_t> daysDistribution(-0x100000, 0x100000);
+    auto test = [&](const char *name, int64_t unitSeconds, std::uniform_int_distribution<int32_t> &distribution) {
+        SCOPED_TRACE(name);
+        int testCount = 0;
+        while (testCount < 10000) {
+            const std::time_t startTime = timeDistribution(engine);
+            const int32_t delta = distribution(engine);
+            const std::time_t expectedTime = startTime + static_cast<std::time_t>(delta) * unitSeconds;
+            if (expectedTime < firstTime || expectedTime > lastTime) {
+                continue;
+            }
+            std::tm startDate = {};
+            gmtime_r(&startTime, &startDate);
+            std::tm expectedDate = {};
+            gmtime_r(&expectedTime, &expectedDate);
+            DateTime dateTime(startDate.tm_year + 1900, startDate.tm_mon + 1, startDate.tm_mday,
+                startDate.tm_hour, startDate.tm_min, startDate.tm_sec);
+            if (unitSeconds == 1) {
+                dateTime.addSeconds(delta);
+            } else if (unitSeconds == 60) {
+                dateTime.addMinutes(delta);
+            } else {
+                dateTime.addDays(delta);
+            }
+            ASSERT_EQ(expectedDate.tm_year + 1900, dateTime.getYear()) << "Start: " << startTime << " Delta: " << delta;
+            ASSERT_EQ(expectedDate.tm_mon + 1, dateTime.getMonth()) << "Start: " << startTime << " Delta: " << delta;
+            ASSERT_EQ(expectedDate.tm_mday, dateTime.getDay()) << "Start: " << startTime << " Delta: " << delta;
+            ASSERT_EQ(expectedDate.tm_hour, dateTime.getHour()) << "Start: " << startTime << " Delta: " << delta;
+            ASSERT_EQ(expectedDate.tm_min, dateTime.getMinute()) << "Start: " << startTime << " Delta: " << delta;
+            ASSERT_EQ(expectedDate.tm_sec, dateTime.getSecond()) << "Start: " << startTime << " Delta: " << delta;
+            ++testCount;
+        }
+    };
+    test("addSeconds()", 1, secondsDistribution);
+    test("addMinutes()", 60, minutesDistribution);
+    test("addDays()", 60*60*24, daysDistribution);
+}
+
+
+/// Test if adding intervals stops at the limits of the date/time range.
+///
+TEST(DateTimeTest, AddIntervalLimits)
+{
+    DateTime dateTime;
+    dateTime.addSeconds(-1);
+    EXPECT_EQ(true, dateTime.isFirst());
+    dateTime.addMinutes(-1);
+    EXPECT_EQ(true, dateTime.isFirst());
+    dateTime.addDays(-1);
+    EXPECT_EQ(true, dateTime.isFirst());
+    dateTime = DateTime(2000, 1, 1, 0, 0, 10);
+    dateTime.addSeconds(-20);
+    EXPECT_EQ(true, dateTime.isFirst());
+
+    const DateTime last(9999, 12, 31, 23, 59, 59);
+    dateTime = last;
+    dateTime.addSeconds(1);
+    EXPECT_EQ(last, dateTime);
+    dateTime.addMinutes(1);
+    EXPECT_EQ(last, dateTime);
+    dateTime.addDays(1);
+    EXPECT_EQ(last, dateTime);
+    dateTime = DateTime(9999, 12, 31, 23, 0, 0);
+    dateTime.addMinutes(120);
+    EXPECT_EQ(last, dateTime);
+
+    // Zero does not change the value.
+    const DateTime custom(2019, 4, 11, 12, 21, 13);
+    dateTime = custom;
+    dateTime.addSeconds(0);
+    dateTime.addMinutes(0);
+    dateTime.addDays(0);
+    EXPECT_EQ(custom, dateTime);
+}
+
+
 #pragma clang diagnostic pop
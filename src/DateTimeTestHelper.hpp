@@ -0,0 +1,62 @@
+//
+// (c)2019 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+#pragma once
+
+
+#include "hal-common/DateTime.hpp"
+
+#include <random>
+
+
+namespace lr::test {
+
+
+/// Get the number of days in a month.
+///
+inline uint8_t getDaysInMonth(uint16_t year, uint8_t month)
+{
+    if (month == 2) {
+        const bool isLeapYear = (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
+        return isLeapYear ? 29 : 28;
+    }
+    return (month == 4 || month == 6 || month == 9 || month == 11) ? 30 : 31;
+}
+
+
+/// Create a random, valid date/time in the given range of years.
+///
+inline DateTime createRandomDateTime(std::ranlux24_base &engine, uint16_t firstYear = 2000, uint16_t lastYear = 9999)
+{
+    std::uniform_int_distribution<uint16_t> yearDistribution(firstYear, lastYear);
+    std::uniform_int_distribution<uint16_t> monthDistribution(1, 12);
+    std::uniform_int_distribution<uint16_t> hourDistribution(0, 23);
+    std::uniform_int_distribution<uint16_t> minuteDistribution(0, 59);
+    std::uniform_int_distribution<uint16_t> secondDistribution(0, 59);
+    const auto year = yearDistribution(engine);
+    const auto month = static_cast<uint8_t>(monthDistribution(engine));
+    std::uniform_int_distribution<uint16_t> dayDistribution(1, getDaysInMonth(year, month));
+    const auto day = static_cast<uint8_t>(dayDistribution(engine));
+    const auto hour = static_cast<uint8_t>(hourDistribution(engine));
+    const auto minute = static_cast<uint8_t>(minuteDistribution(engine));
+    const auto second = static_cast<uint8_t>(secondDistribution(engine));
+    return DateTime(year, month, day, hour, minute, second);
+}
+
+
+}
+
@@ -0,0 +1,145 @@
+//
+// (c)2019 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+#include "DateTimeTestHelper.hpp"
+
+#include "hal-common/PackedDateTime.hpp"
+
+#include "gtest/gtest.h"
+
+#include <random>
+
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#pragma ide diagnostic ignored "cert-msc32-c"
+
+
+using lr::DateTime;
+using lr::PackedDateTime32;
+using lr::PackedDateTime40;
+using lr::test::createRandomDateTime;
+
+
+/// Test the size of the packed representations.
+///
+TEST(PackedDateTimeTest, Size)
+{
+    static_assert(sizeof(PackedDateTime32) == 4, "Expected 32 bits.");
+    static_assert(sizeof(PackedDateTime40) == 5, "Expected 40 bits.");
+    static_assert(sizeof(PackedDateTime40[100]) == 500, "Expected no padding in arrays.");
+}
+
+
+/// Test the construction and the bit layout of the packed values.
+///
+TEST(PackedDateTimeTest, Construction)
+{
+    const PackedDateTime32 first32;
+    EXPECT_EQ(0x00420000u, first32.getValue());
+    EXPECT_EQ(true, first32.toDateTime().isFirst());
+    const PackedDateTime40 first40;
+    EXPECT_EQ(0x00420000u, first40.getValue());
+    EXPECT_EQ(true, first40.toDateTime().isFirst());
+
+    const DateTime custom(2019, 4, 11, 12, 21, 13);
+    const PackedDateTime32 custom32(custom);
+    EXPECT_EQ(0x4d16c54du, custom32.getValue());
+    EXPECT_EQ(custom, custom32.toDateTime());
+    const PackedDateTime40 custom40(custom);
+    EXPECT_EQ(0x4d16c54du, custom40.getValue());
+    EXPECT_EQ(custom, custom40.toDateTime());
+
+    const DateTime last32(2063, 12, 31, 23, 59, 59);
+    EXPECT_EQ(0xff3f7efbu, PackedDateTime32(last32).getValue());
+    EXPECT_EQ(last32, PackedDateTime32(last32).toDateTime());
+    const DateTime last40(9999, 12, 31, 23, 59, 59);
+    EXPECT_EQ(0x7cff3f7efbull, PackedDateTime40(last40).getValue());
+    EXPECT_EQ(last40, PackedDateTime40(last40).toDateTime());
+}
+
+
+/// Test if date/time values after the range of the 32bit representation
+/// are limited to the last value.
+///
+TEST(PackedDateTimeTest, Limits32)
+{
+    const DateTime last32(2063, 12, 31, 23, 59, 59);
+    EXPECT_EQ(last32, PackedDateTime32(DateTime(2064, 1, 1, 0, 0, 0)).toDateTime());
+    EXPECT_EQ(last32, PackedDateTime32(DateTime(2127, 6, 1, 12, 0, 0)).toDateTime());
+    EXPECT_EQ(last32, PackedDateTime32(DateTime(9999, 12, 31, 23, 59, 59)).toDateTime());
+}
+
+
+/// Convert random values to the packed representations and back.
+///
+TEST(PackedDateTimeTest, RoundTrip)
+{
+    std::ranlux24_base engine(0x56); // Fixed value for the tests.
+    for (int i = 0; i < 100000; ++i) {
+        const auto dateTime32 = createRandomDateTime(engine, 2000, 2063);
+        ASSERT_EQ(dateTime32, PackedDateTime32(dateTime32).toDateTime());
+        ASSERT_EQ(dateTime32, PackedDateTime40(dateTime32).toDateTime());
+        const auto dateTime40 = createRandomDateTime(engine, 2000, 9999);
+        ASSERT_EQ(dateTime40, PackedDateTime40(dateTime40).toDateTime());
+    }
+}
+
+
+/// Test if the comparison of the packed values matches the order of `DateTime`.
+///
+TEST(PackedDateTimeTest, Comparison)
+{
+    std::ranlux24_base engine(0x56); // Fixed value for the tests.
+    for (int i = 0; i < 100000; ++i) {
+        auto a = createRandomDateTime(engine, 2000, 2063);
+        auto b = createRandomDateTime(engine, 2000, 2063);
+        if ((i & 3) == 0) {
+            // Also test values which only differ in a single field.
+            b = a;
+            b.setTime(a.getHour(), a.getMinute(), static_cast<uint8_t>(a.getSecond() ^ 1u));
+        } else if ((i & 3) == 1) {
+            b.setDate(a.getYear(), a.getMonth(), b.getDay());
+        }
+        const PackedDateTime32 a32(a);
+        const PackedDateTime32 b32(b);
+        ASSERT_EQ(a == b, a32 == b32);
+        ASSERT_EQ(a != b, a32 != b32);
+        ASSERT_EQ(a < b, a32 < b32);
+        ASSERT_EQ(a <= b, a32 <= b32);
+        ASSERT_EQ(a > b, a32 > b32);
+        ASSERT_EQ(a >= b, a32 >= b32);
+        ASSERT_EQ(a < b, a32.getValue() < b32.getValue());
+        a = createRandomDateTime(engine, 2000, 9999);
+        b = createRandomDateTime(engine, 2000, 9999);
+        if ((i & 3) == 0) {
+            b.setDate(a.getYear(), b.getMonth(), b.getDay());
+        }
+        const PackedDateTime40 a40(a);
+        const PackedDateTime40 b40(b);
+        ASSERT_EQ(a == b, a40 == b40);
+        ASSERT_EQ(a != b, a40 != b40);
+        ASSERT_EQ(a < b, a40 < b40);
+        ASSERT_EQ(a <= b, a40 <= b40);
+        ASSERT_EQ(a > b, a40 > b40);
+        ASSERT_EQ(a >= b, a40 >= b40);
+        ASSERT_EQ(a < b, a40.getValue() < b40.getValue());
+    }
+}
+
+
+#pragma clang diagnostic pop
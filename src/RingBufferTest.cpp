@@ -15,11 +15,19 @@
 // with this program; if not, write to the Free Software Foundation, Inc.,
 // 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 //
+#include "BenchmarkHelper.hpp"
+
 #include "hal-common/RingBuffer.hpp"
+#include "hal-common/LockFreeRingBuffer.hpp"
+#include "hal-common/MultiProducerRingBuffer.hpp"
+#include "hal-common/StaticRingBuffer.hpp"
 
 #include "gtest/gtest.h"
 
+#include <atomic>
 #include <random>
+#include <string>
+#include <thread>
 #include <vector>
 
 #pragma clang diagnostic push
@@ -28,6 +36,11 @@
 
 
 using lr::RingBuffer;
+using lr::RingBufferOverflow;
+using lr::LockFreeRingBuffer;
+using lr::MultiProducerRingBuffer;
+using lr::StaticRingBuffer;
+using lr::test::measure;
 
 
 /// Construct a number of different ring buffers.
@@ -511,4 +524,899 @@ TEST(RingBufferTest, ResetTest)
 }
 
 
+/// Test the lock-free buffer from a single thread.
+/// In contrast to the regular buffer, it rejects data if it is full.
+///
+TEST(RingBufferTest, LockFreeSingleThread)
+{
+    const int bufferSize = 0x40;
+    uint8_t testData[0x80];
+    for (int i = 0; i < 0x80; ++i) {
+        testData[i] = static_cast<uint8_t>(i);
+    }
+    uint8_t readBuffer[0x80];
+    LockFreeRingBuffer<uint16_t, uint8_t> ringBuffer(bufferSize);
+    EXPECT_EQ(false, ringBuffer.isDisabled());
+    EXPECT_EQ(true, ringBuffer.isEnabled());
+    EXPECT_EQ(bufferSize, ringBuffer.getSize());
+    EXPECT_EQ(0, ringBuffer.getCount());
+    EXPECT_EQ(true, ringBuffer.isEmpty());
+    // Fill the buffer, exceeding data is rejected.
+    auto writeCount = ringBuffer.write(testData, 0x30);
+    EXPECT_EQ(0x30, writeCount);
+    EXPECT_EQ(0x30, ringBuffer.getCount());
+    writeCount = ringBuffer.write(testData + 0x30, 0x30);
+    EXPECT_EQ(0x10, writeCount);
+    EXPECT_EQ(bufferSize, ringBuffer.getCount());
+    writeCount = ringBuffer.write(testData, 1);
+    EXPECT_EQ(0, writeCount);
+    // Read back, the oldest data is kept.
+    std::memset(readBuffer, 0, sizeof(readBuffer));
+    auto readCount = ringBuffer.read(readBuffer, 0x80);
+    EXPECT_EQ(bufferSize, readCount);
+    EXPECT_EQ(0, std::memcmp(testData, readBuffer, bufferSize));
+    EXPECT_EQ(true, ringBuffer.isEmpty());
+    // Read to the end mark over the boundary.
+    ringBuffer.write(testData, 0x20);
+    ringBuffer.read(readBuffer, 0x20);
+    ringBuffer.write(testData + 0x10, 0x30);
+    readCount = ringBuffer.readToEnd(readBuffer, 0x80, 0x2f);
+    EXPECT_EQ(0x20, readCount);
+    EXPECT_EQ(0, std::memcmp(testData + 0x10, readBuffer, 0x20));
+    EXPECT_EQ(0x10, ringBuffer.getCount());
+    ringBuffer.reset();
+    EXPECT_EQ(bufferSize, ringBuffer.getSize());
+    EXPECT_EQ(0, ringBuffer.getCount());
+    EXPECT_EQ(true, ringBuffer.isEmpty());
+    // A disabled buffer accepts nothing.
+    LockFreeRingBuffer<uint8_t, uint8_t> disabledBuffer(0);
+    EXPECT_EQ(true, disabledBuffer.isDisabled());
+    EXPECT_EQ(0, disabledBuffer.write(testData, 1));
+    EXPECT_EQ(0, disabledBuffer.read(readBuffer, 1));
+    EXPECT_EQ(0, disabledBuffer.readToEnd(readBuffer, 1, 0));
+}
+
+
+/// Stress test the lock-free buffer with one producer and one consumer thread.
+/// The producer writes a counting sequence in random block sizes, the consumer
+/// reads in random block sizes and checks that no element is lost or reordered.
+///
+TEST(RingBufferTest, LockFreeProducerConsumer)
+{
+    const uint32_t elementCount = 0x40000;
+    auto test = [&](uint16_t bufferSize) {
+        LockFreeRingBuffer<uint16_t, uint32_t> ringBuffer(bufferSize);
+        std::atomic<bool> producerDone(false);
+        std::thread producer([&]() {
+            std::ranlux24_base engine(0x56); // Fixed value for the tests.
+            std::uniform_int_distribution<uint16_t> distribution(1, bufferSize);
+            std::vector<uint32_t> block(bufferSize);
+            uint32_t nextValue = 0;
+            while (nextValue < elementCount) {
+                const auto blockSize = static_cast<uint16_t>(
+                    std::min<uint32_t>(distribution(engine), elementCount - nextValue));
+                for (uint16_t i = 0; i < blockSize; ++i) {
+                    block[i] = nextValue + i;
+                }
+                uint16_t written = 0;
+                while (written < blockSize) {
+                    const auto writeCount = ringBuffer.write(block.data() + written, blockSize - written);
+                    if (writeCount == 0) {
+                        std::this_thread::yield(); // The buffer is full.
+                    }
+                    written += writeCount;
+                }
+                nextValue += blockSize;
+            }
+            producerDone = true;
+        });
+        std::ranlux24_base engine(0x9a); // Fixed value for the tests.
+        std::uniform_int_distribution<uint16_t> distribution(1, bufferSize);
+        std::vector<uint32_t> block(bufferSize);
+        uint32_t totalReadCount = 0;
+        uint32_t expectedValue = 0;
+        bool failed = false;
+        // Keep reading after an error, so the producer is not blocked.
+        // Stop at an empty buffer after the producer is done, so a lost element fails instead of hanging.
+        while (true) {
+            const bool wasProducerDone = producerDone;
+            const auto readCount = ringBuffer.read(block.data(), distribution(engine));
+            if (readCount == 0) {
+                if (wasProducerDone) {
+                    break;
+                }
+                std::this_thread::yield(); // The buffer is empty.
+            }
+            for (uint16_t i = 0; !failed && i < readCount; ++i) {
+                if (block[i] != expectedValue) {
+                    failed = true;
+                    break;
+                }
+                ++expectedValue;
+            }
+            totalReadCount += readCount;
+        }
+        producer.join();
+        ASSERT_EQ(elementCount, totalReadCount);
+        ASSERT_EQ(false, failed);
+        ASSERT_EQ(elementCount, expectedValue);
+        ASSERT_EQ(true, ringBuffer.isEmpty());
+    };
+    // Test various sizes.
+    const uint16_t bufferSizes[] = {0x01, 0x07, 0x10, 0x40, 0x81, 0x100, 0x1000};
+    for (const auto bufferSize : bufferSizes) {
+        test(bufferSize);
+    }
+}
+
+
+namespace {
+
+
+/// A static buffer, placed in static memory without any heap allocation.
+///
+StaticRingBuffer<uint8_t, uint8_t, 0x20> gStaticRingBuffer;
+
+
+}
+
+
+/// Test the state of a buffer with a compile-time size.
+///
+TEST(RingBufferTest, StaticConstruction)
+{
+    static_assert(sizeof(StaticRingBuffer<uint8_t, uint8_t, 0x20>) >= 0x20, "Expected inline storage.");
+    static_assert(sizeof(StaticRingBuffer<uint16_t, uint32_t, 0x100>) >= 0x400, "Expected inline storage.");
+    static_assert(StaticRingBuffer<uint16_t, uint8_t, 0x81>::getSize() == 0x81, "Expected compile-time size.");
+    EXPECT_EQ(false, gStaticRingBuffer.isDisabled());
+    EXPECT_EQ(true, gStaticRingBuffer.isEnabled());
+    EXPECT_EQ(0x20, gStaticRingBuffer.getSize());
+    EXPECT_EQ(0, gStaticRingBuffer.getCount());
+    EXPECT_EQ(true, gStaticRingBuffer.isEmpty());
+    uint8_t dummyByte = 0xaa;
+    gStaticRingBuffer.write(&dummyByte, 1);
+    EXPECT_EQ(1, gStaticRingBuffer.getCount());
+    dummyByte = 0;
+    EXPECT_EQ(1, gStaticRingBuffer.read(&dummyByte, 1));
+    EXPECT_EQ(0xaa, dummyByte);
+    EXPECT_EQ(true, gStaticRingBuffer.isEmpty());
+    gStaticRingBuffer.write(&dummyByte, 1);
+    gStaticRingBuffer.reset();
+    EXPECT_EQ(0x20, gStaticRingBuffer.getSize());
+    EXPECT_EQ(true, gStaticRingBuffer.isEmpty());
+}
+
+
+/// Helper method for the `StaticMatchesDynamic` test.
+/// Runs the same random writes and reads on a static and a dynamic buffer
+/// of the same size and expects identical results.
+///
+template<typename Size, typename Element, Size tSize>
+void testStaticMatchesDynamic()
+{
+    SCOPED_TRACE(std::string("Static buffer size: ") + std::to_string(tSize));
+    StaticRingBuffer<Size, Element, tSize> staticBuffer;
+    RingBuffer<Size, Element> dynamicBuffer(tSize);
+    std::vector<Element> testData(tSize);
+    for (std::size_t i = 0; i < tSize; ++i) {
+        testData[i] = static_cast<Element>(i * 7u + 3u);
+    }
+    std::vector<Element> staticRead(tSize);
+    std::vector<Element> dynamicRead(tSize);
+    std::ranlux24_base engine(0x56); // Fixed value for the tests.
+    std::uniform_int_distribution<Size> distribution(0, tSize);
+    for (int i = 0; i < 0x800; ++i) {
+        const Size writeCount = distribution(engine);
+        staticBuffer.write(testData.data(), writeCount);
+        dynamicBuffer.write(testData.data(), writeCount);
+        ASSERT_EQ(dynamicBuffer.getCount(), staticBuffer.getCount());
+        const Size readCount = distribution(engine);
+        Size staticCount;
+        Size dynamicCount;
+        if ((i & 3) == 0) {
+            const auto endMark = testData[readCount % tSize];
+            staticCount = staticBuffer.readToEnd(staticRead.data(), readCount, endMark);
+            dynamicCount = dynamicBuffer.readToEnd(dynamicRead.data(), readCount, endMark);
+        } else {
+            staticCount = staticBuffer.read(staticRead.data(), readCount);
+            dynamicCount = dynamicBuffer.read(dynamicRead.data(), readCount);
+        }
+        ASSERT_EQ(dynamicCount, staticCount);
+        ASSERT_EQ(0, std::memcmp(dynamicRead.data(), staticRead.data(), sizeof(Element)*staticCount));
+        ASSERT_EQ(dynamicBuffer.getCount(), staticBuffer.getCount());
+    }
+}
+
+
+/// Compare buffers with a compile-time size with the dynamic buffer.
+/// The sizes include powers of two and other sizes.
+///
+TEST(RingBufferTest, StaticMatchesDynamic)
+{
+    testStaticMatchesDynamic<uint8_t, uint8_t, 0x01>();
+    testStaticMatchesDynamic<uint8_t, uint8_t, 0x10>();
+    testStaticMatchesDynamic<uint8_t, uint8_t, 0x1f>();
+    testStaticMatchesDynamic<uint8_t, uint8_t, 0x80>();
+    testStaticMatchesDynamic<uint8_t, uint8_t, 0xff>();
+    testStaticMatchesDynamic<uint16_t, uint8_t, 0x100>();
+    testStaticMatchesDynamic<uint16_t, uint16_t, 0x123>();
+    testStaticMatchesDynamic<uint16_t, uint32_t, 0x400>();
+    testStaticMatchesDynamic<uint32_t, uint64_t, 0x239>();
+}
+
+
+/// Helper method for the `BlockTransfers` test.
+/// Writes and reads every block size, starting at every position in the buffer.
+///
+template<typename Element>
+void testBlockTransfers(uint16_t bufferSize)
+{
+    SCOPED_TRACE(std::string("Buffer size: ") + std::to_string(bufferSize));
+    std::vector<Element> testData(bufferSize);
+    for (uint16_t i = 0; i < bufferSize; ++i) {
+        testData[i] = static_cast<Element>(0x1234u + i * 0x101u);
+    }
+    std::vector<Element> readBuffer(bufferSize);
+    for (uint16_t offset = 0; offset < bufferSize; ++offset) {
+        for (uint16_t blockSize = 1; blockSize <= bufferSize; ++blockSize) {
+            RingBuffer<uint16_t, Element> ringBuffer(bufferSize);
+            // Move the start of the buffer to the offset.
+            ringBuffer.write(testData.data(), offset);
+            ringBuffer.read(readBuffer.data(), offset);
+            ringBuffer.write(testData.data(), blockSize);
+            ASSERT_EQ(blockSize, ringBuffer.getCount());
+            std::fill(readBuffer.begin(), readBuffer.end(), Element());
+            const auto readCount = ringBuffer.read(readBuffer.data(), bufferSize);
+            ASSERT_EQ(blockSize, readCount);
+            ASSERT_EQ(0, std::memcmp(testData.data(), readBuffer.data(), sizeof(Element)*blockSize));
+            ASSERT_EQ(true, ringBuffer.isEmpty());
+        }
+    }
+}
+
+
+/// Test block writes and reads, which are split into at most two copies
+/// at the boundary of the buffer.
+///
+TEST(RingBufferTest, BlockTransfers)
+{
+    testBlockTransfers<uint8_t>(0x01);
+    testBlockTransfers<uint8_t>(0x10);
+    testBlockTransfers<uint8_t>(0x21);
+    testBlockTransfers<uint16_t>(0x1f);
+    testBlockTransfers<uint32_t>(0x40);
+    testBlockTransfers<uint64_t>(0x23);
+}
+
+
+/// Test a buffer with elements which are not trivially copyable.
+///
+TEST(RingBufferTest, NonTrivialElements)
+{
+    const int bufferSize = 0x10;
+    std::string testData[0x30];
+    for (int i = 0; i < 0x30; ++i) {
+        testData[i] = std::string("Element with a long text to avoid small strings ") + std::to_string(i);
+    }
+    std::string readBuffer[bufferSize];
+    RingBuffer<uint8_t, std::string> ringBuffer(bufferSize);
+    // Wrap over the boundary.
+    ringBuffer.write(testData, 0x0c);
+    EXPECT_EQ(0x0c, ringBuffer.read(readBuffer, 0x0c));
+    ringBuffer.write(testData, 0x0a);
+    auto readCount = ringBuffer.read(readBuffer, bufferSize);
+    ASSERT_EQ(0x0a, readCount);
+    for (int i = 0; i < readCount; ++i) {
+        EXPECT_EQ(testData[i], readBuffer[i]);
+    }
+    // Drop exceeding data.
+    ringBuffer.write(testData, 0x30);
+    readCount = ringBuffer.read(readBuffer, bufferSize);
+    ASSERT_EQ(bufferSize, readCount);
+    for (int i = 0; i < readCount; ++i) {
+        EXPECT_EQ(testData[0x20 + i], readBuffer[i]);
+    }
+}
+
+
+/// Measure the throughput of block writes and reads for all block sizes.
+///
+TEST(RingBufferTest, DISABLED_BenchmarkBlockTransfers)
+{
+    const uint32_t bufferSize = 0x1000;
+    const uint64_t bytesPerBlockSize = 0x4000000;
+    std::vector<uint8_t> testData(bufferSize, 0xaa);
+    std::vector<uint8_t> readBuffer(bufferSize);
+    RingBuffer<uint16_t, uint8_t> ringBuffer(bufferSize);
+    for (uint32_t blockSize = 1; blockSize <= bufferSize; blockSize *= 2) {
+        const uint64_t iterations = bytesPerBlockSize / blockSize;
+        // Shift the start, so blocks regularly cross the boundary.
+        ringBuffer.reset();
+        ringBuffer.write(testData.data(), 0x123);
+        ringBuffer.read(readBuffer.data(), 0x123);
+        measure("Block size " + std::to_string(blockSize), static_cast<double>(iterations * blockSize), "bytes", [&]() {
+            uint64_t checksum = 0;
+            for (uint64_t i = 0; i < iterations; ++i) {
+                ringBuffer.write(testData.data(), static_cast<uint16_t>(blockSize));
+                checksum += ringBuffer.read(readBuffer.data(), static_cast<uint16_t>(blockSize));
+            }
+            return checksum;
+        });
+    }
+}
+
+
+/// Test writing into the buffer using the write spans.
+/// The spans are filled directly and committed, then read back using `read()`.
+///
+TEST(RingBufferTest, WriteSpans)
+{
+    const uint16_t bufferSize = 0x31;
+    uint8_t testData[bufferSize];
+    for (uint16_t i = 0; i < bufferSize; ++i) {
+        testData[i] = static_cast<uint8_t>(0x80u + i);
+    }
+    uint8_t readBuffer[bufferSize];
+    for (uint16_t offset = 0; offset < bufferSize; ++offset) {
+        for (uint16_t fillCount = 0; fillCount <= bufferSize; fillCount += 3) {
+            RingBuffer<uint16_t, uint8_t> ringBuffer(bufferSize);
+            // Move the start of the buffer to the offset and pre-fill it.
+            ringBuffer.write(testData, offset);
+            ringBuffer.read(readBuffer, offset);
+            ringBuffer.write(testData, fillCount);
+            // Get the free space as spans.
+            auto spans = ringBuffer.acquireWriteSpans();
+            ASSERT_EQ(bufferSize - fillCount, spans.first.size + spans.second.size);
+            if (spans.second.size > 0) {
+                ASSERT_NE(0, spans.first.size);
+                ASSERT_LE(spans.second.data + spans.second.size, spans.first.data);
+            }
+            // Fill the spans and commit them.
+            const uint16_t writeCount = spans.first.size + spans.second.size;
+            // An empty span may have no data pointer.
+            if (spans.first.size > 0) {
+                std::memcpy(spans.first.data, testData + fillCount, spans.first.size);
+            }
+            if (spans.second.size > 0) {
+                std::memcpy(spans.second.data, testData + fillCount + spans.first.size, spans.second.size);
+            }
+            ringBuffer.commitWrite(writeCount);
+            ASSERT_EQ(bufferSize, ringBuffer.getCount());
+            spans = ringBuffer.acquireWriteSpans();
+            ASSERT_EQ(0, spans.first.size);
+            ASSERT_EQ(0, spans.second.size);
+            std::memset(readBuffer, 0, bufferSize);
+            const auto readCount = ringBuffer.read(readBuffer, bufferSize);
+            ASSERT_EQ(bufferSize, readCount);
+            ASSERT_EQ(0, std::memcmp(testData, readBuffer, bufferSize));
+        }
+    }
+}
+
+
+/// Test reading from the buffer using the read spans.
+/// The data is written using `write()` and consumed from the spans.
+///
+TEST(RingBufferTest, ReadSpans)
+{
+    const uint16_t bufferSize = 0x2c;
+    uint16_t testData[bufferSize];
+    for (uint16_t i = 0; i < bufferSize; ++i) {
+        testData[i] = static_cast<uint16_t>(0x1000u + i);
+    }
+    uint16_t readBuffer[bufferSize];
+    for (uint16_t offset = 0; offset < bufferSize; ++offset) {
+        for (uint16_t fillCount = 0; fillCount <= bufferSize; fillCount += 5) {
+            RingBuffer<uint8_t, uint16_t> ringBuffer(bufferSize);
+            // Move the start of the buffer to the offset and fill it.
+            ringBuffer.write(testData, static_cast<uint8_t>(offset));
+            ringBuffer.read(readBuffer, static_cast<uint8_t>(offset));
+            ringBuffer.write(testData, static_cast<uint8_t>(fillCount));
+            // Get the data as spans.
+            auto spans = ringBuffer.peekReadSpans();
+            ASSERT_EQ(fillCount, spans.first.size + spans.second.size);
+            if (spans.second.size > 0) {
+                ASSERT_LE(spans.second.data + spans.second.size, spans.first.data);
+            }
+            if (spans.first.size > 0) {
+                ASSERT_EQ(0, std::memcmp(testData, spans.first.data, sizeof(uint16_t)*spans.first.size));
+            }
+            if (spans.second.size > 0) {
+                ASSERT_EQ(0, std::memcmp(testData + spans.first.size, spans.second.data, sizeof(uint16_t)*spans.second.size));
+            }
+            // Peeking does not change the buffer.
+            ASSERT_EQ(fillCount, ringBuffer.getCount());
+            // Consume the first half and read the rest.
+            const uint16_t consumeCount = fillCount / 2;
+            ringBuffer.consumeRead(static_cast<uint8_t>(consumeCount));
+            ASSERT_EQ(fillCount - consumeCount, ringBuffer.getCount());
+            const auto readCount = ringBuffer.read(readBuffer, bufferSize);
+            ASSERT_EQ(fillCount - consumeCount, readCount);
+            ASSERT_EQ(0, std::memcmp(testData + consumeCount, readBuffer, sizeof(uint16_t)*readCount));
+            spans = ringBuffer.peekReadSpans();
+            ASSERT_EQ(0, spans.first.size);
+            ASSERT_EQ(0, spans.second.size);
+        }
+    }
+}
+
+
+/// Test partial commits, limits and the spans of a disabled buffer.
+///
+TEST(RingBufferTest, SpanLimits)
+{
+    const uint8_t bufferSize = 0x10;
+    RingBuffer<uint8_t, uint8_t> ringBuffer(bufferSize);
+    auto writeSpans = ringBuffer.acquireWriteSpans();
+    ASSERT_EQ(bufferSize, writeSpans.first.size);
+    ASSERT_EQ(0, writeSpans.second.size);
+    std::memset(writeSpans.first.data, 0x5a, 4);
+    ringBuffer.commitWrite(4);
+    EXPECT_EQ(4, ringBuffer.getCount());
+    // Committing more than the free space is limited to the buffer size.
+    ringBuffer.commitWrite(0x20);
+    EXPECT_EQ(bufferSize, ringBuffer.getCount());
+    auto readSpans = ringBuffer.peekReadSpans();
+    ASSERT_EQ(bufferSize, readSpans.first.size + readSpans.second.size);
+    EXPECT_EQ(0x5a, readSpans.first.data[0]);
+    EXPECT_EQ(0x5a, readSpans.first.data[3]);
+    // Consuming more than the available data empties the buffer.
+    ringBuffer.consumeRead(0x20);
+    EXPECT_EQ(0, ringBuffer.getCount());
+    EXPECT_EQ(true, ringBuffer.isEmpty());
+    // A disabled buffer has no spans.
+    RingBuffer<uint8_t, uint8_t> disabledBuffer(0);
+    writeSpans = disabledBuffer.acquireWriteSpans();
+    EXPECT_EQ(0, writeSpans.first.size);
+    EXPECT_EQ(0, writeSpans.second.size);
+    disabledBuffer.commitWrite(1); // no crash...
+    readSpans = disabledBuffer.peekReadSpans();
+    EXPECT_EQ(0, readSpans.first.size);
+    EXPECT_EQ(0, readSpans.second.size);
+    disabledBuffer.consumeRead(1); // no crash...
+    EXPECT_EQ(true, disabledBuffer.isEmpty());
+}
+
+
+/// Helper method for the `ReadToEndScan` test.
+/// Places the end mark at every position of a full buffer, starting at every
+/// offset, and reads with different maximum sizes.
+///
+template<typename Element>
+void testReadToEndScan(uint16_t bufferSize, Element endMark)
+{
+    SCOPED_TRACE(std::string("Buffer size: ") + std::to_string(bufferSize) +
+        " End mark: " + std::to_string(static_cast<int64_t>(endMark)));
+    std::vector<Element> testData(bufferSize);
+    std::vector<Element> readBuffer(bufferSize);
+    const uint16_t readSizes[] = {1, 0x07, 0x10, 0x21, bufferSize};
+    for (uint16_t offset = 0; offset < bufferSize; offset += 3) {
+        // A mark position equal to the buffer size means no end mark.
+        for (uint16_t markPosition = 0; markPosition <= bufferSize; ++markPosition) {
+            for (uint16_t i = 0; i < bufferSize; ++i) {
+                // Values which differ from the end mark, only in some bits.
+                testData[i] = static_cast<Element>(endMark ^ static_cast<Element>(0x10u | (i & 0x0fu)));
+            }
+            if (markPosition < bufferSize) {
+                testData[markPosition] = endMark;
+            }
+            for (const auto readSize : readSizes) {
+                if (readSize > bufferSize) {
+                    continue;
+                }
+                RingBuffer<uint16_t, Element> ringBuffer(bufferSize);
+                // Move the start of the buffer to the offset and fill it.
+                ringBuffer.write(testData.data(), offset);
+                ringBuffer.read(readBuffer.data(), offset);
+                ringBuffer.write(testData.data(), bufferSize);
+                const uint16_t expectedCount = std::min<uint16_t>(readSize, markPosition + 1);
+                const auto readCount = ringBuffer.readToEnd(readBuffer.data(), readSize, endMark);
+                ASSERT_EQ(expectedCount, readCount);
+                ASSERT_EQ(0, std::memcmp(testData.data(), readBuffer.data(), sizeof(Element)*readCount));
+                ASSERT_EQ(bufferSize - readCount, ringBuffer.getCount());
+            }
+        }
+    }
+}
+
+
+/// Helper method for the `ReadToEndScan` test.
+/// Fills every slot of the buffer with the end mark and reads it again, so stale
+/// end marks are left outside of the valid range. Then stores fewer elements than
+/// the size, with and without an end mark, and checks that the stale marks are ignored.
+///
+template<typename Element>
+void testReadToEndStaleMarks(uint16_t bufferSize, Element endMark)
+{
+    SCOPED_TRACE(std::string("Stale marks. Buffer size: ") + std::to_string(bufferSize) +
+        " End mark: " + std::to_string(static_cast<int64_t>(endMark)));
+    const std::vector<Element> marks(bufferSize, endMark);
+    std::vector<Element> testData(bufferSize);
+    std::vector<Element> readBuffer(bufferSize);
+    for (uint16_t i = 0; i < bufferSize; ++i) {
+        testData[i] = static_cast<Element>(endMark ^ static_cast<Element>(0x10u | (i & 0x0fu)));
+    }
+    for (uint16_t offset = 0; offset < bufferSize; offset += 5) {
+        for (uint16_t storedCount = 1; storedCount < bufferSize; ++storedCount) {
+            // A mark position equal to the stored count means no end mark.
+            const uint16_t markPositions[] = {storedCount, static_cast<uint16_t>(storedCount - 1), 0};
+            for (const auto markPosition : markPositions) {
+                std::vector<Element> storedData(testData.begin(), testData.begin() + storedCount);
+                if (markPosition < storedCount) {
+                    storedData[markPosition] = endMark;
+                }
+                RingBuffer<uint16_t, Element> ringBuffer(bufferSize);
+                // Leave the end mark in every slot, with the start at the offset.
+                ringBuffer.write(marks.data(), offset);
+                ringBuffer.read(readBuffer.data(), offset);
+                ringBuffer.write(marks.data(), bufferSize);
+                ASSERT_EQ(bufferSize, ringBuffer.read(readBuffer.data(), bufferSize));
+                ringBuffer.write(storedData.data(), storedCount);
+                const uint16_t expectedCount = std::min<uint16_t>(storedCount, markPosition + 1);
+                const auto readCount = ringBuffer.readToEnd(readBuffer.data(), bufferSize, endMark);
+                ASSERT_EQ(expectedCount, readCount);
+                ASSERT_EQ(0, std::memcmp(storedData.data(), readBuffer.data(), sizeof(Element)*readCount));
+                ASSERT_EQ(storedCount - readCount, ringBuffer.getCount());
+            }
+        }
+    }
+}
+
+
+/// Test `readToEnd()` with the end mark at every position of the buffer.
+/// This covers the cases where the scan crosses the boundary of the buffer,
+/// the scan of long sequences without an end mark, and stale end marks
+/// outside of the stored elements.
+///
+TEST(RingBufferTest, ReadToEndScan)
+{
+    testReadToEndScan<uint8_t>(0x01, 0xff);
+    testReadToEndScan<uint8_t>(0x0f, 0x0a);
+    testReadToEndScan<uint8_t>(0x90, 0xff);
+    testReadToEndScan<uint8_t>(0x90, 0x00);
+    testReadToEndScan<uint8_t>(0x93, 0x80);
+    testReadToEndScan<char>(0x61, '\n');
+    testReadToEndScan<int8_t>(0x47, -1);
+    testReadToEndScan<uint32_t>(0x45, 0xffffffffu);
+    testReadToEndStaleMarks<uint8_t>(0x02, 0xff);
+    testReadToEndStaleMarks<uint8_t>(0x90, 0x00);
+    testReadToEndStaleMarks<uint8_t>(0x93, 0x80);
+    testReadToEndStaleMarks<char>(0x61, '\n');
+    testReadToEndStaleMarks<uint32_t>(0x45, 0xffffffffu);
+}
+
+
+/// Measure the number of messages per second read using `readToEnd()`.
+///
+TEST(RingBufferTest, DISABLED_BenchmarkReadToEnd)
+{
+    const uint32_t bufferSize = 0x1000;
+    const uint64_t bytesPerMessageLength = 0x4000000;
+    const char endMark = '\n';
+    std::vector<char> readBuffer(bufferSize);
+    RingBuffer<uint16_t, char> ringBuffer(bufferSize);
+    const uint32_t messageLengths[] = {4, 8, 16, 32, 64, 128, 256, 1024, 4096};
+    for (const auto messageLength : messageLengths) {
+        std::vector<char> message(messageLength, 'x');
+        message.back() = endMark;
+        const uint64_t iterations = bytesPerMessageLength / messageLength;
+        // Shift the start, so messages regularly cross the boundary.
+        ringBuffer.reset();
+        ringBuffer.write(readBuffer.data(), 0x123);
+        ringBuffer.read(readBuffer.data(), 0x123);
+        measure("Message length " + std::to_string(messageLength), static_cast<double>(iterations), "messages", [&]() {
+            uint64_t checksum = 0;
+            for (uint64_t i = 0; i < iterations; ++i) {
+                ringBuffer.write(message.data(), static_cast<uint16_t>(messageLength));
+                checksum += ringBuffer.readToEnd(readBuffer.data(), static_cast<uint16_t>(bufferSize), endMark);
+            }
+            return checksum;
+        });
+    }
+}
+
+
+/// Test the default overflow policy, which drops the oldest data.
+/// All elements are accepted and the overwritten ones are counted.
+///
+TEST(RingBufferTest, OverflowDropOldest)
+{
+    const uint8_t bufferSize = 0x20;
+    uint8_t testData[0x50];
+    for (uint8_t i = 0; i < 0x50; ++i) {
+        testData[i] = i;
+    }
+    uint8_t readBuffer[bufferSize];
+    RingBuffer<uint8_t, uint8_t, RingBufferOverflow::DropOldest> ringBuffer(bufferSize);
+    EXPECT_EQ(0, ringBuffer.getDroppedCount());
+    EXPECT_EQ(0x18, ringBuffer.write(testData, 0x18));
+    EXPECT_EQ(0, ringBuffer.getDroppedCount());
+    EXPECT_EQ(0x18, ringBuffer.write(testData + 0x18, 0x18));
+    EXPECT_EQ(0x10, ringBuffer.getDroppedCount());
+    EXPECT_EQ(0x20, ringBuffer.write(testData + 0x30, 0x20));
+    EXPECT_EQ(0x30, ringBuffer.getDroppedCount());
+    EXPECT_EQ(bufferSize, ringBuffer.read(readBuffer, bufferSize));
+    EXPECT_EQ(0, std::memcmp(testData + 0x30, readBuffer, bufferSize));
+    // Reading does not change the counter, resetting the buffer does.
+    EXPECT_EQ(0x30, ringBuffer.getDroppedCount());
+    ringBuffer.reset();
+    EXPECT_EQ(0, ringBuffer.getDroppedCount());
+}
+
+
+/// Test the overflow policy which rejects new data.
+/// Only the elements which fit are accepted, the rejected ones are counted.
+///
+TEST(RingBufferTest, OverflowRejectNew)
+{
+    const uint8_t bufferSize = 0x20;
+    uint8_t testData[0x50];
+    for (uint8_t i = 0; i < 0x50; ++i) {
+        testData[i] = i;
+    }
+    uint8_t readBuffer[bufferSize];
+    RingBuffer<uint8_t, uint8_t, RingBufferOverflow::RejectNew> ringBuffer(bufferSize);
+    EXPECT_EQ(0, ringBuffer.getDroppedCount());
+    EXPECT_EQ(0x18, ringBuffer.write(testData, 0x18));
+    EXPECT_EQ(0, ringBuffer.getDroppedCount());
+    EXPECT_EQ(0x08, ringBuffer.write(testData + 0x18, 0x18));
+    EXPECT_EQ(0x10, ringBuffer.getDroppedCount());
+    EXPECT_EQ(bufferSize, ringBuffer.getCount());
+    EXPECT_EQ(0, ringBuffer.write(testData, 1));
+    EXPECT_EQ(0x11, ringBuffer.getDroppedCount());
+    // The oldest data is kept.
+    EXPECT_EQ(0x10, ringBuffer.read(readBuffer, 0x10));
+    EXPECT_EQ(0, std::memcmp(testData, readBuffer, 0x10));
+    // After reading, there is space for new data, also over the boundary.
+    EXPECT_EQ(0x10, ringBuffer.write(testData + 0x20, 0x30));
+    EXPECT_EQ(0x31, ringBuffer.getDroppedCount());
+    EXPECT_EQ(bufferSize, ringBuffer.read(readBuffer, bufferSize));
+    EXPECT_EQ(0, std::memcmp(testData + 0x10, readBuffer, bufferSize));
+    ringBuffer.reset();
+    EXPECT_EQ(0, ringBuffer.getDroppedCount());
+    EXPECT_EQ(true, ringBuffer.isEmpty());
+    // A disabled buffer rejects everything.
+    RingBuffer<uint8_t, uint8_t, RingBufferOverflow::RejectNew> disabledBuffer(0);
+    EXPECT_EQ(0, disabledBuffer.write(testData, 0x10));
+    EXPECT_EQ(0x10, disabledBuffer.getDroppedCount());
+}
+
+
+/// Test random writes and reads with the policy which rejects new data.
+/// The accepted data has to be read back without gaps.
+///
+TEST(RingBufferTest, OverflowRejectNewSequence)
+{
+    const uint16_t testDataSize = 0x100;
+    uint16_t testData[testDataSize];
+    uint16_t readBuffer[testDataSize];
+    std::ranlux24_base engine(0x56); // Fixed value for the tests.
+    std::uniform_int_distribution<uint16_t> distribution(0, testDataSize);
+    auto test = [&](uint16_t bufferSize) {
+        RingBuffer<uint16_t, uint16_t, RingBufferOverflow::RejectNew> ringBuffer(bufferSize);
+        uint16_t nextWriteValue = 0;
+        uint16_t nextReadValue = 0;
+        uint32_t expectedDropped = 0;
+        for (int i = 0; i < 0x800; ++i) {
+            const uint16_t writeCount = distribution(engine);
+            for (uint16_t j = 0; j < writeCount; ++j) {
+                testData[j] = static_cast<uint16_t>(nextWriteValue + j);
+            }
+            const uint16_t expectedWriteCount = std::min<uint16_t>(writeCount, bufferSize - ringBuffer.getCount());
+            const auto actualWriteCount = ringBuffer.write(testData, writeCount);
+            ASSERT_EQ(expectedWriteCount, actualWriteCount);
+            nextWriteValue += actualWriteCount;
+            expectedDropped += writeCount - actualWriteCount;
+            ASSERT_EQ(expectedDropped, ringBuffer.getDroppedCount());
+            const auto readCount = ringBuffer.read(readBuffer, distribution(engine));
+            for (uint16_t j = 0; j < readCount; ++j) {
+                ASSERT_EQ(nextReadValue, readBuffer[j]);
+                ++nextReadValue;
+            }
+            ASSERT_EQ(static_cast<uint16_t>(nextWriteValue - nextReadValue), ringBuffer.getCount());
+        }
+    };
+    // Test various sizes.
+    const uint16_t bufferSizes[] = {0x08, 0x0f, 0x10, 0x21, 0x40, 0x7f, 0x80, 0xc8, 0xff, 0x100, 0x123};
+    for (const auto bufferSize : bufferSizes) {
+        test(bufferSize);
+    }
+}
+
+
+/// Test the multi producer buffer from a single thread.
+/// A block is either accepted as a whole or rejected.
+///
+TEST(RingBufferTest, MultiProducerSingleThread)
+{
+    const uint16_t bufferSize = 0x40;
+    uint8_t testData[0x80];
+    for (int i = 0; i < 0x80; ++i) {
+        testData[i] = static_cast<uint8_t>(i);
+    }
+    uint8_t readBuffer[0x80];
+    MultiProducerRingBuffer<uint16_t, uint8_t> ringBuffer(bufferSize);
+    EXPECT_EQ(false, ringBuffer.isDisabled());
+    EXPECT_EQ(true, ringBuffer.isEnabled());
+    EXPECT_EQ(bufferSize, ringBuffer.getSize());
+    EXPECT_EQ(0, ringBuffer.getCount());
+    EXPECT_EQ(true, ringBuffer.isEmpty());
+    EXPECT_EQ(0x30, ringBuffer.write(testData, 0x30));
+    EXPECT_EQ(0x30, ringBuffer.getCount());
+    // This block does not fit and is rejected.
+    EXPECT_EQ(0, ringBuffer.write(testData + 0x30, 0x11));
+    EXPECT_EQ(0x30, ringBuffer.getCount());
+    EXPECT_EQ(0x10, ringBuffer.write(testData + 0x30, 0x10));
+    EXPECT_EQ(bufferSize, ringBuffer.getCount());
+    EXPECT_EQ(0, ringBuffer.write(testData, 1));
+    EXPECT_EQ(bufferSize, ringBuffer.read(readBuffer, 0x80));
+    EXPECT_EQ(0, std::memcmp(testData, readBuffer, bufferSize));
+    // Blocks larger than the buffer are never accepted.
+    EXPECT_EQ(0, ringBuffer.write(testData, bufferSize + 1));
+    // Read to the end mark over the boundary.
+    ringBuffer.write(testData, 0x20);
+    ringBuffer.read(readBuffer, 0x20);
+    ringBuffer.write(testData + 0x10, 0x30);
+    auto readCount = ringBuffer.readToEnd(readBuffer, 0x80, 0x2f);
+    EXPECT_EQ(0x20, readCount);
+    EXPECT_EQ(0, std::memcmp(testData + 0x10, readBuffer, 0x20));
+    EXPECT_EQ(0x10, ringBuffer.getCount());
+    ringBuffer.reset();
+    EXPECT_EQ(bufferSize, ringBuffer.getSize());
+    EXPECT_EQ(0, ringBuffer.getCount());
+    EXPECT_EQ(true, ringBuffer.isEmpty());
+    // A disabled buffer accepts nothing.
+    MultiProducerRingBuffer<uint8_t, uint8_t> disabledBuffer(0);
+    EXPECT_EQ(true, disabledBuffer.isDisabled());
+    EXPECT_EQ(0, disabledBuffer.write(testData, 1));
+    EXPECT_EQ(0, disabledBuffer.read(readBuffer, 1));
+    EXPECT_EQ(0, disabledBuffer.readToEnd(readBuffer, 1, 0));
+}
+
+
+namespace {
+
+
+/// Helper to encode the elements for the multi producer tests.
+/// Each element contains the producer, a flag for the last element of a block
+/// and a sequence number per producer.
+///
+struct ProducerElement
+{
+    static uint32_t encode(uint32_t producer, bool isLastInBlock, uint32_t sequence) {
+        return (producer << 24u) | (isLastInBlock ? 0x800000u : 0u) | (sequence & 0x7fffffu);
+    }
+    static uint32_t getProducer(uint32_t element) { return element >> 24u; }
+    static bool isLastInBlock(uint32_t element) { return (element & 0x800000u) != 0; }
+    static uint32_t getSequence(uint32_t element) { return element & 0x7fffffu; }
+};
+
+
+/// Run a number of producer threads which write blocks into the buffer.
+/// The consumer gets the number of producers which are done.
+///
+template<typename RunConsumer>
+void runProducers(MultiProducerRingBuffer<uint16_t, uint32_t> &ringBuffer,
+    uint32_t producerCount, uint32_t elementsPerProducer, RunConsumer runConsumer)
+{
+    std::atomic<uint32_t> doneCount(0);
+    std::vector<std::thread> producers;
+    for (uint32_t producer = 0; producer < producerCount; ++producer) {
+        producers.emplace_back([&ringBuffer, &doneCount, producer, elementsPerProducer]() {
+            std::ranlux24_base engine(0x56 + producer); // Fixed value for the tests.
+            std::uniform_int_distribution<uint32_t> distribution(1, 8);
+            uint32_t block[8];
+            uint32_t sequence = 0;
+            while (sequence < elementsPerProducer) {
+                const uint32_t blockSize = std::min(distribution(engine), elementsPerProducer - sequence);
+                for (uint32_t i = 0; i < blockSize; ++i) {
+                    block[i] = ProducerElement::encode(producer, i == blockSize - 1, sequence + i);
+                }
+                while (ringBuffer.write(block, static_cast<uint16_t>(blockSize)) == 0) {
+                    std::this_thread::yield(); // The buffer is full.
+                }
+                sequence += blockSize;
+            }
+            ++doneCount;
+        });
+    }
+    runConsumer(doneCount);
+    for (auto &producer : producers) {
+        producer.join();
+    }
+}
+
+
+}
+
+
+/// Stress test the multi producer buffer with a number of producer threads.
+/// The consumer checks the order of the elements of each producer and that
+/// blocks are not interleaved with elements of other producers.
+///
+TEST(RingBufferTest, MultiProducerConsumer)
+{
+    const uint32_t elementsPerProducer = 0x10000;
+    auto test = [&](uint16_t bufferSize, uint32_t producerCount) {
+        SCOPED_TRACE(std::string("Buffer size: ") + std::to_string(bufferSize) +
+            " Producers: " + std::to_string(producerCount));
+        MultiProducerRingBuffer<uint16_t, uint32_t> ringBuffer(bufferSize);
+        std::vector<uint32_t> nextSequence(producerCount, 0);
+        uint32_t readCount = 0;
+        uint32_t errorCount = 0;
+        runProducers(ringBuffer, producerCount, elementsPerProducer, [&](const std::atomic<uint32_t> &doneCount) {
+            std::vector<uint32_t> block(bufferSize);
+            bool isInBlock = false;
+            uint32_t blockProducer = 0;
+            // The same loop as in `LockFreeProducerConsumer`, ending when all producers are done.
+            while (true) {
+                const bool wereProducersDone = (doneCount == producerCount);
+                const auto count = ringBuffer.read(block.data(), bufferSize);
+                if (count == 0) {
+                    if (wereProducersDone) {
+                        break;
+                    }
+                    std::this_thread::yield(); // The buffer is empty.
+                }
+                for (uint16_t i = 0; errorCount == 0 && i < count; ++i) {
+                    const auto producer = ProducerElement::getProducer(block[i]);
+                    if (producer >= producerCount || (isInBlock && producer != blockProducer) ||
+                        ProducerElement::getSequence(block[i]) != nextSequence[producer]) {
+                        ++errorCount;
+                        break;
+                    }
+                    nextSequence[producer] += 1;
+                    isInBlock = !ProducerElement::isLastInBlock(block[i]);
+                    blockProducer = producer;
+                }
+                readCount += count;
+            }
+        });
+        ASSERT_EQ(producerCount * elementsPerProducer, readCount);
+        ASSERT_EQ(0, errorCount);
+        for (const auto sequence : nextSequence) {
+            ASSERT_EQ(elementsPerProducer, sequence);
+        }
+        ASSERT_EQ(true, ringBuffer.isEmpty());
+    };
+    test(0x08, 2);
+    test(0x40, 2);
+    test(0x40, 4);
+    test(0x100, 8);
+    test(0x1000, 4);
+}
+
+
+/// Measure the throughput of the multi producer buffer with 1 to 16 producers.
+///
+TEST(RingBufferTest, DISABLED_BenchmarkMultiProducer)
+{
+    const uint32_t elementCount = 0x1000000;
+    for (uint32_t producerCount = 1; producerCount <= 16; producerCount *= 2) {
+        MultiProducerRingBuffer<uint16_t, uint32_t> ringBuffer(0x1000);
+        const uint32_t elementsPerProducer = elementCount / producerCount;
+        uint32_t readCount = 0;
+        const auto totalCount = static_cast<double>(producerCount * elementsPerProducer);
+        measure("Producers " + std::to_string(producerCount), totalCount, "elements", [&]() {
+            runProducers(ringBuffer, producerCount, elementsPerProducer, [&](const std::atomic<uint32_t> &doneCount) {
+                std::vector<uint32_t> block(0x1000);
+                while (true) {
+                    const bool wereProducersDone = (doneCount == producerCount);
+                    const auto count = ringBuffer.read(block.data(), 0x1000);
+                    if (count == 0) {
+                        if (wereProducersDone) {
+                            break;
+                        }
+                        std::this_thread::yield(); // The buffer is empty.
+                    }
+                    readCount += count;
+                }
+            });
+            return readCount;
+        });
+        ASSERT_EQ(producerCount * elementsPerProducer, readCount);
+    }
+}
+
+
 #pragma clang diagnostic pop
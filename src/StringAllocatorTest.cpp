@@ -0,0 +1,312 @@
+//
+// (c)2019 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+#include "BenchmarkHelper.hpp"
+
+#include "hal-common/StringAllocator.hpp"
+#include "hal-common/String.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#pragma ide diagnostic ignored "cert-msc32-c"
+
+
+using lr::String;
+using lr::StringAllocator;
+using lr::StringAllocatorScope;
+using lr::StringArenaAllocator;
+using lr::StringPoolAllocator;
+using lr::test::measure;
+
+
+namespace {
+
+
+/// A text which is too long for the inline storage of a string.
+///
+const char* const cLongText = "a text which is stored on the heap";
+
+
+/// Check if a pointer is aligned for any string buffer.
+///
+bool isAligned(const void *ptr)
+{
+    return (reinterpret_cast<std::uintptr_t>(ptr) % alignof(std::max_align_t)) == 0;
+}
+
+
+}
+
+
+/// Test the fixed block pool allocator.
+///
+TEST(StringAllocatorTest, Pool)
+{
+    StringPoolAllocator<64, 8> pool;
+    EXPECT_EQ(64, pool.getBlockSize());
+    EXPECT_EQ(8, pool.getBlockCount());
+    EXPECT_EQ(8, pool.getFreeBlockCount());
+    std::set<void*> blocks;
+    for (int i = 0; i < 8; ++i) {
+        void *block = pool.allocate(1 + i * 8);
+        ASSERT_NE(nullptr, block);
+        EXPECT_EQ(true, pool.contains(block));
+        EXPECT_EQ(true, isAligned(block));
+        blocks.insert(block);
+    }
+    EXPECT_EQ(8u, blocks.size());
+    EXPECT_EQ(0, pool.getFreeBlockCount());
+    // An exhausted pool fails.
+    EXPECT_EQ(nullptr, pool.allocate(1));
+    // The last released block is reused first.
+    void *released = *blocks.begin();
+    pool.deallocate(released, 16);
+    EXPECT_EQ(1, pool.getFreeBlockCount());
+    EXPECT_EQ(released, pool.allocate(16));
+    for (const auto block : blocks) {
+        pool.deallocate(block, 64);
+    }
+    EXPECT_EQ(8, pool.getFreeBlockCount());
+    // Blocks larger than the block size fail.
+    EXPECT_EQ(nullptr, pool.allocate(65));
+    EXPECT_EQ(8, pool.getFreeBlockCount());
+    int outside = 0;
+    EXPECT_EQ(false, pool.contains(&outside));
+}
+
+
+/// Test the bump allocator of the arena.
+///
+TEST(StringAllocatorTest, Arena)
+{
+    StringArenaAllocator<1024> arena;
+    EXPECT_EQ(1024, arena.getCapacity());
+    EXPECT_EQ(0, arena.getUsedSize());
+    void *first = arena.allocate(10);
+    void *second = arena.allocate(10);
+    ASSERT_NE(nullptr, first);
+    ASSERT_NE(nullptr, second);
+    EXPECT_EQ(true, arena.contains(first));
+    EXPECT_EQ(true, arena.contains(second));
+    EXPECT_EQ(true, isAligned(first));
+    EXPECT_EQ(true, isAligned(second));
+    EXPECT_LT(first, second);
+    EXPECT_GE(arena.getUsedSize(), 20);
+    // Releasing single blocks does not free any memory.
+    const auto usedSize = arena.getUsedSize();
+    arena.deallocate(second, 10);
+    EXPECT_EQ(usedSize, arena.getUsedSize());
+    // A full arena fails.
+    EXPECT_EQ(nullptr, arena.allocate(1024));
+    EXPECT_EQ(usedSize, arena.getUsedSize());
+    // Reset frees everything at once.
+    arena.reset();
+    EXPECT_EQ(0, arena.getUsedSize());
+    EXPECT_EQ(first, arena.allocate(10));
+    arena.reset();
+    EXPECT_NE(nullptr, arena.allocate(1024));
+    EXPECT_EQ(nullptr, arena.allocate(1));
+}
+
+
+/// Test strings using an allocator in a scope.
+///
+TEST(StringAllocatorTest, Scope)
+{
+    StringArenaAllocator<4096> arena;
+    const String before(cLongText);
+    EXPECT_EQ(false, arena.contains(before.getData()));
+    {
+        StringAllocatorScope scope(arena);
+        EXPECT_EQ(&arena, &StringAllocator::getCurrent());
+        const String inside(cLongText);
+        EXPECT_EQ(true, arena.contains(inside.getData()));
+        // Short strings stay in the inline storage.
+        const auto usedSize = arena.getUsedSize();
+        const String shortString("short");
+        EXPECT_EQ(usedSize, arena.getUsedSize());
+        EXPECT_EQ(false, arena.contains(shortString.getData()));
+        // Copies and appends made in the scope use the arena.
+        const String copy(before);
+        EXPECT_EQ(true, arena.contains(copy.getData()));
+        EXPECT_EQ(before, copy);
+        String appended("x");
+        appended.append(cLongText);
+        EXPECT_EQ(true, arena.contains(appended.getData()));
+    }
+    EXPECT_NE(&arena, &StringAllocator::getCurrent());
+    const String after(cLongText);
+    EXPECT_EQ(false, arena.contains(after.getData()));
+    // Scopes can be nested.
+    StringPoolAllocator<64, 4> pool;
+    {
+        StringAllocatorScope outerScope(arena);
+        {
+            StringAllocatorScope innerScope(pool);
+            const String inner(cLongText);
+            EXPECT_EQ(true, pool.contains(inner.getData()));
+        }
+        const String outer(cLongText);
+        EXPECT_EQ(true, arena.contains(outer.getData()));
+    }
+    EXPECT_EQ(4, pool.getFreeBlockCount());
+}
+
+
+/// Test that each buffer is released to the allocator which created it.
+///
+TEST(StringAllocatorTest, ReleaseToOwner)
+{
+    StringPoolAllocator<64, 4> pool;
+    auto heapString = std::make_unique<String>(cLongText);
+    std::unique_ptr<String> poolString;
+    {
+        StringAllocatorScope scope(pool);
+        poolString = std::make_unique<String>(cLongText);
+        EXPECT_EQ(3, pool.getFreeBlockCount());
+        // A heap string destroyed in the scope goes back to the heap.
+        heapString.reset();
+        EXPECT_EQ(3, pool.getFreeBlockCount());
+    }
+    // A pool string destroyed outside of the scope goes back to the pool.
+    poolString.reset();
+    EXPECT_EQ(4, pool.getFreeBlockCount());
+    // Assigning a heap string which fits reuses the pool block.
+    {
+        StringAllocatorScope scope(pool);
+        poolString = std::make_unique<String>(cLongText);
+        EXPECT_EQ(3, pool.getFreeBlockCount());
+    }
+    const String heapSource("another text stored on the heap");
+    *poolString = heapSource;
+    EXPECT_EQ(true, pool.contains(poolString->getData()));
+    EXPECT_EQ(heapSource, *poolString);
+    EXPECT_EQ(3, pool.getFreeBlockCount());
+    // Growing beyond the block size releases the block to the pool.
+    poolString->append(cLongText);
+    poolString->append(cLongText);
+    EXPECT_EQ(false, pool.contains(poolString->getData()));
+    EXPECT_EQ(4, pool.getFreeBlockCount());
+    poolString.reset();
+    EXPECT_EQ(4, pool.getFreeBlockCount());
+}
+
+
+/// Test strings which do not fit into the pool.
+///
+TEST(StringAllocatorTest, PoolFallback)
+{
+    StringPoolAllocator<32, 2> pool;
+    StringAllocatorScope scope(pool);
+    const String first(cLongText); // too long for a block.
+    EXPECT_EQ(false, pool.contains(first.getData()));
+    EXPECT_EQ(String(cLongText), first);
+    const String second("sixteen chars...");
+    const String third("seventeen chars..");
+    EXPECT_EQ(true, pool.contains(second.getData()));
+    EXPECT_EQ(true, pool.contains(third.getData()));
+    // An exhausted pool falls back to the heap.
+    const String fourth("eighteen chars....");
+    EXPECT_EQ(false, pool.contains(fourth.getData()));
+    EXPECT_EQ(String("eighteen chars...."), fourth);
+}
+
+
+/// Test many command processing cycles in one arena.
+///
+TEST(StringAllocatorTest, ArenaCycles)
+{
+    StringArenaAllocator<0x4000> arena;
+    std::ranlux24_base engine(0x9a); // Fixed value for the tests.
+    std::uniform_int_distribution<int32_t> distribution(-1000000, 1000000);
+    for (int cycle = 0; cycle < 1000; ++cycle) {
+        {
+            StringAllocatorScope scope(arena);
+            std::vector<String> fields;
+            String line("command.with.a.long.name");
+            for (int i = 0; i < 10; ++i) {
+                const auto value = distribution(engine);
+                fields.push_back(String::number(value));
+                line.append(';');
+                line.append(fields.back());
+                ASSERT_EQ(value, fields.back().toInt32().getValue());
+            }
+            const String copy(line);
+            ASSERT_EQ(line, copy);
+            ASSERT_EQ(true, arena.contains(line.getData()));
+            ASSERT_EQ(true, arena.contains(copy.getData()));
+        }
+        ASSERT_GT(arena.getUsedSize(), 0);
+        arena.reset();
+        ASSERT_EQ(0, arena.getUsedSize());
+    }
+}
+
+
+/// Compare string copies using the heap, the pool and the arena.
+///
+TEST(StringAllocatorTest, DISABLED_BenchmarkCopy)
+{
+    const int cycleCount = 0x10000;
+    const int copyCount = 32;
+    const String source(cLongText);
+    measure("Heap", cycleCount * copyCount, "copies", [&]() {
+        uint64_t checksum = 0;
+        for (int cycle = 0; cycle < cycleCount; ++cycle) {
+            std::vector<String> copies(copyCount, source);
+            checksum += copies.back().getLength();
+        }
+        return checksum;
+    });
+    StringPoolAllocator<64, copyCount> pool;
+    measure("StringPoolAllocator", cycleCount * copyCount, "copies", [&]() {
+        uint64_t checksum = 0;
+        for (int cycle = 0; cycle < cycleCount; ++cycle) {
+            StringAllocatorScope scope(pool);
+            std::vector<String> copies(copyCount, source);
+            checksum += copies.back().getLength();
+        }
+        return checksum;
+    });
+    StringArenaAllocator<0x1000> arena;
+    measure("StringArenaAllocator", cycleCount * copyCount, "copies", [&]() {
+        uint64_t checksum = 0;
+        for (int cycle = 0; cycle < cycleCount; ++cycle) {
+            {
+                StringAllocatorScope scope(arena);
+                std::vector<String> copies(copyCount, source);
+                checksum += copies.back().getLength();
+            }
+            arena.reset();
+        }
+        return checksum;
+    });
+}
+
+
+#pragma clang diagnostic pop
@@ -0,0 +1,303 @@
+//
+// (c)2019 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+#include "BenchmarkHelper.hpp"
+
+#include "hal-common/StringInternTable.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#pragma ide diagnostic ignored "cert-msc32-c"
+
+
+using lr::InternedString;
+using lr::String;
+using lr::StringHandle;
+using lr::StringInternTable;
+using lr::StringView;
+using lr::test::measure;
+
+
+namespace {
+
+
+/// Create a list of distinct keywords, with shared prefixes to make a full compare expensive.
+///
+std::vector<std::string> createKeywords(std::size_t count)
+{
+    std::vector<std::string> keywords;
+    keywords.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        keywords.push_back("config.section.keyword" + std::to_string(i));
+    }
+    return keywords;
+}
+
+
+}
+
+
+/// Test the hash of strings and literals.
+///
+TEST(StringInternTableTest, Hash)
+{
+    static_assert(String::hash("reset") == String::hash("reset"), "The hash of a literal has to be a constant.");
+    static_assert(String::hash("reset") != String::hash("resel"), "Different literals should have different hashes.");
+    EXPECT_EQ(String::hash("reset"), String("reset").getHash());
+    EXPECT_EQ(String::hash(""), String().getHash());
+    EXPECT_EQ(String::hash("reset"), StringView("reset now", 5).getHash());
+    // The hash is the same for short and long strings.
+    const std::string longText(100, 'x');
+    EXPECT_EQ(String::hash(longText.c_str()), String(longText.c_str()).getHash());
+    // No collisions in a typical set of keywords.
+    const auto keywords = createKeywords(1000);
+    std::vector<uint32_t> hashes;
+    for (const auto &keyword : keywords) {
+        hashes.push_back(String(keyword.c_str()).getHash());
+    }
+    std::sort(hashes.begin(), hashes.end());
+    EXPECT_EQ(hashes.end(), std::adjacent_find(hashes.begin(), hashes.end()));
+}
+
+
+/// Test the handles.
+///
+TEST(StringInternTableTest, Handle)
+{
+    static_assert(sizeof(StringHandle) <= sizeof(uint32_t), "A handle has to fit into a register.");
+    const StringHandle invalid;
+    EXPECT_EQ(false, invalid.isValid());
+    EXPECT_EQ(true, (invalid == StringHandle()));
+    StringInternTable<16> table;
+    const auto a = table.intern("a").getValue();
+    const auto b = table.intern("b").getValue();
+    EXPECT_EQ(true, a.isValid());
+    EXPECT_EQ(true, b.isValid());
+    EXPECT_EQ(true, (a == a));
+    EXPECT_EQ(false, (a == b));
+    EXPECT_EQ(true, (a != b));
+    EXPECT_EQ(true, (a != invalid));
+    EXPECT_NE(a.getIndex(), b.getIndex());
+}
+
+
+/// Test interning and finding strings.
+///
+TEST(StringInternTableTest, InternAndFind)
+{
+    StringInternTable<64> table;
+    EXPECT_EQ(64, table.getCapacity());
+    EXPECT_EQ(0, table.getCount());
+    EXPECT_EQ(false, table.find("reset").isValid());
+    const auto reset = table.intern("reset");
+    ASSERT_EQ(true, reset.isSuccess());
+    EXPECT_EQ(1, table.getCount());
+    // The same text always returns the same handle, from a literal, a string or a view.
+    EXPECT_EQ(reset.getValue(), table.intern("reset").getValue());
+    EXPECT_EQ(reset.getValue(), table.intern(String("reset")).getValue());
+    EXPECT_EQ(reset.getValue(), table.find("reset"));
+    EXPECT_EQ(reset.getValue(), table.find(String("reset")));
+    EXPECT_EQ(reset.getValue(), table.find(StringView("reset all", 5)));
+    EXPECT_EQ(1, table.getCount());
+    // Finding never inserts a string.
+    EXPECT_EQ(false, table.find("resets").isValid());
+    EXPECT_EQ(false, table.find("rese").isValid());
+    EXPECT_EQ(false, table.find("").isValid());
+    EXPECT_EQ(1, table.getCount());
+    // The table keeps its own copy of the text.
+    StringHandle handle;
+    {
+        String temporary("temporary");
+        handle = table.intern(temporary).getValue();
+    }
+    EXPECT_EQ(String("temporary"), table.getString(handle));
+    EXPECT_EQ(String("reset"), table.getString(reset.getValue()));
+    // The empty string is a valid key.
+    const auto empty = table.intern("");
+    ASSERT_EQ(true, empty.isSuccess());
+    EXPECT_EQ(empty.getValue(), table.find(String()));
+    EXPECT_EQ(true, table.getString(empty.getValue()).isEmpty());
+}
+
+
+/// Test a full table.
+///
+TEST(StringInternTableTest, Full)
+{
+    StringInternTable<8> table;
+    std::vector<StringHandle> handles;
+    for (int i = 0; i < 8; ++i) {
+        const auto result = table.intern(String::number(i));
+        ASSERT_EQ(true, result.isSuccess());
+        handles.push_back(result.getValue());
+    }
+    EXPECT_EQ(8, table.getCount());
+    EXPECT_EQ(true, table.intern("8").hasError());
+    EXPECT_EQ(8, table.getCount());
+    // Existing strings are still found in a full table.
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_EQ(handles[i], table.intern(String::number(i)).getValue());
+        EXPECT_EQ(handles[i], table.find(String::number(i)));
+    }
+    EXPECT_EQ(false, table.find("8").isValid());
+}
+
+
+/// Test many keywords, with collisions in the open addressing.
+///
+TEST(StringInternTableTest, ManyKeywords)
+{
+    const auto keywords = createKeywords(500);
+    StringInternTable<512> table;
+    std::vector<StringHandle> handles;
+    for (const auto &keyword : keywords) {
+        const auto result = table.intern(keyword.c_str());
+        ASSERT_EQ(true, result.isSuccess());
+        handles.push_back(result.getValue());
+    }
+    EXPECT_EQ(500, table.getCount());
+    for (std::size_t i = 0; i < keywords.size(); ++i) {
+        SCOPED_TRACE(std::string("Keyword: ") + keywords[i]);
+        ASSERT_EQ(handles[i], table.find(keywords[i].c_str()));
+        ASSERT_EQ(String(keywords[i].c_str()), table.getString(handles[i]));
+        for (std::size_t j = i + 1; j < keywords.size(); j += 37) {
+            ASSERT_NE(handles[i], handles[j]);
+        }
+    }
+    // Unknown tokens with the same prefixes are not found.
+    for (std::size_t i = 500; i < 1000; ++i) {
+        const std::string unknown = "config.section.keyword" + std::to_string(i);
+        ASSERT_EQ(false, table.find(unknown.c_str()).isValid());
+    }
+}
+
+
+/// Test the comparison operators with interned strings.
+///
+TEST(StringInternTableTest, Compare)
+{
+    StringInternTable<16> table;
+    const InternedString reset = table.get(table.intern("reset").getValue());
+    const InternedString status = table.get(table.intern("status").getValue());
+    EXPECT_EQ(String("reset"), reset.getString());
+    EXPECT_EQ(table.find("reset"), reset.getHandle());
+    EXPECT_EQ(String::hash("reset"), reset.getHash());
+    // Two interned strings compare by their handle.
+    EXPECT_EQ(true, (reset == table.get(table.find("reset"))));
+    EXPECT_EQ(false, (reset == status));
+    EXPECT_EQ(true, (reset != status));
+    // Owned strings, views and literals compare with the text, on either side.
+    EXPECT_EQ(true, (String("reset") == reset));
+    EXPECT_EQ(true, (reset == String("reset")));
+    EXPECT_EQ(false, (String("resel") == reset));
+    EXPECT_EQ(true, (String("resets") != reset));
+    EXPECT_EQ(true, (StringView("reset all", 5) == reset));
+    EXPECT_EQ(false, (StringView("reset all", 4) == reset));
+    EXPECT_EQ(true, (reset == "reset"));
+    EXPECT_EQ(true, (reset != "status"));
+    EXPECT_EQ(false, (String() == reset));
+}
+
+
+/// Test dispatching random tokens, compared with a linear search.
+///
+TEST(StringInternTableTest, Dispatch)
+{
+    const auto keywords = createKeywords(200);
+    StringInternTable<256> table;
+    std::vector<StringHandle> handles;
+    for (const auto &keyword : keywords) {
+        handles.push_back(table.intern(keyword.c_str()).getValue());
+    }
+    std::ranlux24_base engine(0x9a); // Fixed value for the tests.
+    std::uniform_int_distribution<std::size_t> distribution(0, keywords.size() * 2 - 1);
+    for (int i = 0; i < 10000; ++i) {
+        const std::size_t index = distribution(engine);
+        const std::string text = "config.section.keyword" + std::to_string(index);
+        const String token(text.c_str());
+        std::size_t expected = keywords.size();
+        for (std::size_t j = 0; j < keywords.size(); ++j) {
+            if (token == keywords[j].c_str()) {
+                expected = j;
+                break;
+            }
+        }
+        const auto handle = table.find(token);
+        if (expected == keywords.size()) {
+            ASSERT_EQ(false, handle.isValid());
+        } else {
+            ASSERT_EQ(handles[expected], handle);
+        }
+    }
+}
+
+
+/// Compare keyword dispatch using handles with a linear search using `operator==`.
+///
+TEST(StringInternTableTest, DISABLED_BenchmarkDispatch)
+{
+    const std::size_t keywordCount = 300;
+    const int tokenCount = 0x10000;
+    const auto keywords = createKeywords(keywordCount);
+    std::vector<String> keywordStrings;
+    StringInternTable<512> table;
+    // The dispatch table maps the index of a handle to the keyword.
+    std::vector<std::size_t> keywordByIndex(table.getCapacity(), keywordCount);
+    for (std::size_t j = 0; j < keywordCount; ++j) {
+        keywordStrings.emplace_back(keywords[j].c_str());
+        keywordByIndex[table.intern(keywords[j].c_str()).getValue().getIndex()] = j;
+    }
+    std::ranlux24_base engine(0x9a); // Fixed value for the tests.
+    std::uniform_int_distribution<std::size_t> distribution(0, keywordCount - 1);
+    std::vector<String> tokens;
+    for (int i = 0; i < tokenCount; ++i) {
+        tokens.emplace_back(keywords[distribution(engine)].c_str());
+    }
+    measure("StringInternTable", tokenCount, "tokens", [&]() {
+        uint64_t checksum = 0;
+        for (const auto &token : tokens) {
+            const auto handle = table.find(token);
+            if (handle.isValid()) {
+                checksum += keywordByIndex[handle.getIndex()];
+            }
+        }
+        return checksum;
+    });
+    measure("String::operator==", tokenCount, "tokens", [&]() {
+        uint64_t checksum = 0;
+        for (const auto &token : tokens) {
+            for (std::size_t j = 0; j < keywordCount; ++j) {
+                if (token == keywordStrings[j]) {
+                    checksum += j;
+                    break;
+                }
+            }
+        }
+        return checksum;
+    });
+}
+
+
+#pragma clang diagnostic pop
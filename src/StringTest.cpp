@@ -15,16 +15,30 @@
 // with this program; if not, write to the Free Software Foundation, Inc.,
 // 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 //
+#include "BenchmarkHelper.hpp"
+#include "StringTestHelper.hpp"
+
 #include "hal-common/String.hpp"
 
 #include "gtest/gtest.h"
 
+#include <charconv>
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
 #include <random>
-#include <sstream>
 #include <csignal>
+#include <cstring>
+#include <string>
+#include <vector>
 
 
 using namespace lr;
+using lr::test::measure;
+using lr::test::testStringToNumber;
 
 
 TEST(StringTest, Create)
@@ -100,67 +114,814 @@ TEST(StringTest, Append)
     EXPECT_EQ(a, "TextRun:");
 }
 
+
+namespace {
+
+
+bool isStoredInline(const String &str)
+{
+    const auto objectStart = reinterpret_cast<const char*>(&str);
+    return str.getData() >= objectStart && str.getData() < objectStart + sizeof(String);
+}
+
+
+}
+
+
+TEST(StringTest, SmallStringStorage)
+{
+    EXPECT_LE(sizeof(String), 24);
+    const std::string source = "0123456789abcdefghijklmnopqrstuvwxyz";
+    for (String::Length length = 0; length < 33; ++length) {
+        SCOPED_TRACE(std::string("Length: ") + std::to_string(length));
+        const String str(source.data(), length);
+        EXPECT_EQ(str.getLength(), length);
+        EXPECT_EQ(std::string(str.getData()), source.substr(0, length));
+        EXPECT_EQ(str.getData()[length], '\0');
+        if (length < 16) {
+            EXPECT_EQ(isStoredInline(str), true);
+        }
+        // Copies keep their own storage.
+        const String copy(str);
+        EXPECT_EQ(copy, str);
+        EXPECT_EQ(isStoredInline(copy), isStoredInline(str));
+        if (length > 0) {
+            EXPECT_NE(copy.getData(), str.getData());
+        }
+        // Assign between short and long strings in both directions.
+        String shortStr("short");
+        shortStr = str;
+        EXPECT_EQ(shortStr, str);
+        EXPECT_EQ(shortStr.getLength(), length);
+        String longStr(source.c_str());
+        longStr = str;
+        EXPECT_EQ(longStr, str);
+        EXPECT_EQ(longStr.getLength(), length);
+        const String &sameStr = longStr;
+        longStr = sameStr; // self assignment
+        EXPECT_EQ(longStr, str);
+        longStr = String(source.c_str());
+        EXPECT_EQ(longStr, source.c_str());
+    }
+}
+
+
+TEST(StringTest, SmallStringAppend)
+{
+    // Append single characters, crossing the limit of the inline storage.
+    String a;
+    std::string expected;
+    for (int i = 0; i < 40; ++i) {
+        const char c = static_cast<char>('a' + (i % 26));
+        a.append(c);
+        expected += c;
+        EXPECT_EQ(a.getLength(), expected.size());
+        EXPECT_EQ(std::string(a.getData()), expected);
+        EXPECT_EQ((a == expected.c_str()), true);
+    }
+    // Append strings, ending exactly at the limit of the inline storage.
+    String b("0123456");
+    b.append(String("789abcde"));
+    EXPECT_EQ(b, "0123456789abcde");
+    EXPECT_EQ(b.getLength(), 15);
+    EXPECT_EQ(isStoredInline(b), true);
+    b.append("f");
+    EXPECT_EQ(b, "0123456789abcdef");
+    EXPECT_EQ(b.getLength(), 16);
+    // Append a string to itself.
+    String c("abc");
+    c.append(c);
+    EXPECT_EQ(c, "abcabc");
+    c.append(c);
+    c.append(c);
+    EXPECT_EQ(c, "abcabcabcabcabcabcabcabc");
+    // Compare short and long strings.
+    EXPECT_EQ((String("abc") < String("abcdefghijklmnopqrstuvwxyz")), true);
+    EXPECT_EQ((String("abcdefghijklmnopqrstuvwxyz") > String("abc")), true);
+    EXPECT_EQ((String("abcdefghijklmnop") == String("abcdefghijklmnop")), true);
+}
+
+
+TEST(StringTest, Reserve)
+{
+    String a;
+    EXPECT_GE(a.getCapacity(), 15);
+    a.reserve(100);
+    EXPECT_GE(a.getCapacity(), 100);
+    EXPECT_EQ(a.isEmpty(), true);
+    EXPECT_EQ(a, "");
+    // Appending within the reserved capacity keeps the buffer.
+    const auto data = a.getData();
+    std::string expected;
+    for (int i = 0; i < 100; ++i) {
+        const char c = static_cast<char>('a' + (i % 26));
+        a.append(c);
+        expected += c;
+    }
+    EXPECT_EQ(a.getData(), data);
+    EXPECT_EQ(std::string(a.getData()), expected);
+    // A smaller reserve does nothing.
+    const auto capacity = a.getCapacity();
+    a.reserve(10);
+    EXPECT_EQ(a.getCapacity(), capacity);
+    EXPECT_EQ(a.getData(), data);
+    EXPECT_EQ(std::string(a.getData()), expected);
+    // Reserve on a string with content keeps the content.
+    String b("Text");
+    b.reserve(1000);
+    EXPECT_GE(b.getCapacity(), 1000);
+    EXPECT_EQ(b, "Text");
+    EXPECT_EQ(b.getLength(), 4);
+}
+
+
+TEST(StringTest, GeometricGrowth)
+{
+    String a;
+    std::string expected;
+    String::Length lastCapacity = a.getCapacity();
+    int reallocationCount = 0;
+    for (int i = 0; i < 0x10000; ++i) {
+        const char c = static_cast<char>('a' + (i % 26));
+        a.append(c);
+        expected += c;
+        ASSERT_GE(a.getCapacity(), a.getLength());
+        if (a.getCapacity() != lastCapacity) {
+            // Each growth step adds at least half of the capacity.
+            ASSERT_GE(a.getCapacity(), lastCapacity + lastCapacity / 2);
+            lastCapacity = a.getCapacity();
+            ++reallocationCount;
+        }
+    }
+    EXPECT_LE(reallocationCount, 24);
+    EXPECT_EQ(a.getLength(), expected.size());
+    EXPECT_EQ(std::string(a.getData()), expected);
+    // Appending large blocks may grow beyond the doubled capacity.
+    String b("x");
+    b.append(expected.c_str());
+    EXPECT_EQ(b.getLength(), expected.size() + 1);
+    EXPECT_GE(b.getCapacity(), b.getLength());
+    // Appending a string to itself while it grows.
+    String c("0123456789abcdef");
+    c.append(c);
+    c.append(c.getData());
+    EXPECT_EQ(c, "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef");
+}
+
+
+TEST(StringTest, ShrinkToFit)
+{
+    String a("abc");
+    a.reserve(1000);
+    a.shrinkToFit();
+    EXPECT_LT(a.getCapacity(), 1000);
+    EXPECT_EQ(a, "abc");
+    EXPECT_EQ(isStoredInline(a), true);
+    String b;
+    b.reserve(1000);
+    for (int i = 0; i < 100; ++i) {
+        b.append('x');
+    }
+    b.shrinkToFit();
+    EXPECT_GE(b.getCapacity(), 100);
+    EXPECT_LT(b.getCapacity(), 1000);
+    EXPECT_EQ(b.getLength(), 100);
+    EXPECT_EQ(std::string(b.getData()), std::string(100, 'x'));
+    // The string can grow again after shrinking.
+    b.append("yz");
+    EXPECT_EQ(b.getLength(), 102);
+    EXPECT_EQ(std::string(b.getData()), std::string(100, 'x') + "yz");
+    String empty;
+    empty.shrinkToFit();
+    EXPECT_EQ(empty.isEmpty(), true);
+    EXPECT_EQ(empty, "");
+}
+
+
+/// Compare building a 64KB string one character at a time with `std::string`.
+///
+TEST(StringTest, DISABLED_BenchmarkAppendCharacters)
+{
+    const int length = 0x10000;
+    const int repeatCount = 100;
+    measure("String::append", repeatCount, "64KB strings", [&]() {
+        std::size_t checksum = 0;
+        for (int repeat = 0; repeat < repeatCount; ++repeat) {
+            String text;
+            for (int i = 0; i < length; ++i) {
+                text.append(static_cast<char>('a' + (i % 26)));
+            }
+            checksum += text.getLength();
+        }
+        return checksum;
+    });
+    measure("std::string", repeatCount, "64KB strings", [&]() {
+        std::size_t checksum = 0;
+        for (int repeat = 0; repeat < repeatCount; ++repeat) {
+            std::string text;
+            for (int i = 0; i < length; ++i) {
+                text += static_cast<char>('a' + (i % 26));
+            }
+            checksum += text.size();
+        }
+        return checksum;
+    });
+}
+
 // TODO: Test append and various other methods.
 
+
+TEST(StringTest, StringToNumber)
+{
+    testStringToNumber<String, int8_t>(&String::toInt8, "int8_t");
+    testStringToNumber<String, uint8_t>(&String::toUInt8, "uint8_t");
+    testStringToNumber<String, int16_t>(&String::toInt16, "int16_t");
+    testStringToNumber<String, uint16_t>(&String::toUInt16, "uint16_t");
+    testStringToNumber<String, int32_t>(&String::toInt32, "int32_t");
+    testStringToNumber<String, uint32_t>(&String::toUInt32, "uint32_t");
+}
+
+
+namespace {
+
+
 template<typename IntType>
-void stringToNumberTests(StatusResult<IntType>(String::*memberFn)() const, const std::string &type)
+void expectNumberLikeToChars(IntType value)
 {
-    SCOPED_TRACE(std::string("String to number tests: ") + type);
-    String a;
-    a = "";
-    StatusResult<IntType> result = (a.*memberFn)();
-    EXPECT_EQ(result.hasError(), true);
-    a = "test";
-    result = (a.*memberFn)();
-    EXPECT_EQ(result.hasError(), true);
-    a = " 12";
-    result = (a.*memberFn)();
-    EXPECT_EQ(result.hasError(), true);
-    a = "x12";
-    result = (a.*memberFn)();
-    EXPECT_EQ(result.hasError(), true);
-    a = "  ";
-    result = (a.*memberFn)();
-    EXPECT_EQ(result.hasError(), true);
-    a = "0";
-    result = (a.*memberFn)();
-    EXPECT_EQ(result.isSuccess(), true);
-    EXPECT_EQ(result.getValue(), 0);
-    a = "12";
-    result = (a.*memberFn)();
-    EXPECT_EQ(result.isSuccess(), true);
-    EXPECT_EQ(result.getValue(), 12);
-    a = String::number(std::numeric_limits<IntType>::max());
-    result = (a.*memberFn)();
-    EXPECT_EQ(result.isSuccess(), true);
-    EXPECT_EQ(result.getValue(), std::numeric_limits<IntType>::max());
-    a = String::number(std::numeric_limits<IntType>::min());
-    result = (a.*memberFn)();
-    EXPECT_EQ(result.isSuccess(), true);
-    EXPECT_EQ(result.getValue(), std::numeric_limits<IntType>::min());
-
-    // Test some random numbers.
+    char expected[24];
+    const auto result = std::to_chars(expected, expected + sizeof(expected), value);
+    *result.ptr = '\0';
+    const String valueStr = String::number(value);
+    ASSERT_EQ(std::string(valueStr.getData()), std::string(expected));
+    ASSERT_EQ(valueStr.getLength(), static_cast<String::Length>(result.ptr - expected));
+}
+
+
+}
+
+
+TEST(StringTest, NumberDigitCounts)
+{
+    // Every value around a change of the digit count.
+    for (uint32_t power = 1; power <= 1000000000u; power *= 10) {
+        SCOPED_TRACE(std::string("Power: ") + std::to_string(power));
+        ASSERT_NO_FATAL_FAILURE(expectNumberLikeToChars<uint32_t>(power - 1));
+        ASSERT_NO_FATAL_FAILURE(expectNumberLikeToChars<uint32_t>(power));
+        ASSERT_NO_FATAL_FAILURE(expectNumberLikeToChars<uint32_t>(power + 1));
+        ASSERT_NO_FATAL_FAILURE(expectNumberLikeToChars<int32_t>(static_cast<int32_t>(power - 1)));
+        ASSERT_NO_FATAL_FAILURE(expectNumberLikeToChars<int32_t>(static_cast<int32_t>(power)));
+        ASSERT_NO_FATAL_FAILURE(expectNumberLikeToChars<int32_t>(-static_cast<int32_t>(power - 1)));
+        ASSERT_NO_FATAL_FAILURE(expectNumberLikeToChars<int32_t>(-static_cast<int32_t>(power)));
+        ASSERT_NO_FATAL_FAILURE(expectNumberLikeToChars<int32_t>(-static_cast<int32_t>(power) - 1));
+        if (power == 1000000000u) {
+            break;
+        }
+    }
+    ASSERT_NO_FATAL_FAILURE(expectNumberLikeToChars<uint32_t>(std::numeric_limits<uint32_t>::max()));
+    ASSERT_NO_FATAL_FAILURE(expectNumberLikeToChars<int32_t>(std::numeric_limits<int32_t>::max()));
+    ASSERT_NO_FATAL_FAILURE(expectNumberLikeToChars<int32_t>(std::numeric_limits<int32_t>::min()));
+    // All 8bit and 16bit values.
+    for (int32_t value = std::numeric_limits<int16_t>::min(); value <= std::numeric_limits<uint16_t>::max(); ++value) {
+        if (value >= std::numeric_limits<int8_t>::min() && value <= std::numeric_limits<int8_t>::max()) {
+            ASSERT_NO_FATAL_FAILURE(expectNumberLikeToChars<int8_t>(static_cast<int8_t>(value)));
+        }
+        if (value >= 0 && value <= std::numeric_limits<uint8_t>::max()) {
+            ASSERT_NO_FATAL_FAILURE(expectNumberLikeToChars<uint8_t>(static_cast<uint8_t>(value)));
+        }
+        if (value <= std::numeric_limits<int16_t>::max()) {
+            ASSERT_NO_FATAL_FAILURE(expectNumberLikeToChars<int16_t>(static_cast<int16_t>(value)));
+        }
+        if (value >= 0) {
+            ASSERT_NO_FATAL_FAILURE(expectNumberLikeToChars<uint16_t>(static_cast<uint16_t>(value)));
+        }
+    }
+}
+
+
+TEST(StringTest, StringToNumberDigitBlocks)
+{
+    // Leading zeros, crossing the blocks of digits parsed in one step.
+    std::string text = "12345";
+    for (int i = 0; i < 20; ++i) {
+        SCOPED_TRACE(std::string("Text: ") + text);
+        const String str(text.c_str());
+        EXPECT_EQ(str.toUInt32().isSuccess(), true);
+        EXPECT_EQ(str.toUInt32().getValue(), 12345);
+        EXPECT_EQ(str.toInt32().getValue(), 12345);
+        EXPECT_EQ(str.toUInt16().getValue(), 12345);
+        EXPECT_EQ(str.toInt16().getValue(), 12345);
+        EXPECT_EQ(String(("-" + text).c_str()).toInt32().getValue(), -12345);
+        text = "0" + text;
+    }
+    // Values at the overflow limit.
+    EXPECT_EQ(String("4294967295").toUInt32().getValue(), 4294967295u);
+    EXPECT_EQ(String("0004294967295").toUInt32().getValue(), 4294967295u);
+    EXPECT_EQ(String("4294967296").toUInt32().hasError(), true);
+    EXPECT_EQ(String("4294967300").toUInt32().hasError(), true);
+    EXPECT_EQ(String("9999999999").toUInt32().hasError(), true);
+    EXPECT_EQ(String("42949672950").toUInt32().hasError(), true);
+    EXPECT_EQ(String("99999999999999999999").toUInt32().hasError(), true);
+    EXPECT_EQ(String("2147483647").toInt32().getValue(), 2147483647);
+    EXPECT_EQ(String("2147483648").toInt32().hasError(), true);
+    EXPECT_EQ(String("-2147483648").toInt32().getValue(), std::numeric_limits<int32_t>::min());
+    EXPECT_EQ(String("-2147483649").toInt32().hasError(), true);
+    EXPECT_EQ(String("65535").toUInt16().getValue(), 65535);
+    EXPECT_EQ(String("65536").toUInt16().hasError(), true);
+    EXPECT_EQ(String("-32769").toInt16().hasError(), true);
+    EXPECT_EQ(String("256").toUInt8().hasError(), true);
+    EXPECT_EQ(String("-129").toInt8().hasError(), true);
+    // A single invalid character at each position.
+    // The digits are zero padded, so every length is in range without the invalid character.
+    const std::string digits = "0000000000001234";
+    const char invalidCharacters[] = {' ', '/', ':', 'a', '-', '+', '.', '\x80'};
+    for (std::size_t length = 1; length <= digits.size(); ++length) {
+        const String validStr(digits.substr(0, length).c_str());
+        ASSERT_EQ(validStr.toUInt32().isSuccess(), true);
+        ASSERT_EQ(validStr.toInt32().isSuccess(), true);
+        for (std::size_t position = 0; position < length; ++position) {
+            for (const auto invalidCharacter : invalidCharacters) {
+                std::string invalidText = digits.substr(0, length);
+                invalidText[position] = invalidCharacter;
+                if (position == 0 && invalidCharacter == '-' && length > 1) {
+                    continue; // A valid negative number.
+                }
+                SCOPED_TRACE(std::string("Text: ") + invalidText);
+                const String str(invalidText.c_str());
+                ASSERT_EQ(str.toUInt32().hasError(), true);
+                ASSERT_EQ(str.toInt32().hasError(), true);
+            }
+        }
+    }
+}
+
+
+/// Compare the number conversions with `snprintf`, `strtol` and `std::to_chars`/`std::from_chars`.
+///
+TEST(StringTest, DISABLED_BenchmarkNumberConversion)
+{
+    const std::size_t count = 0x100000;
     std::ranlux24_base engine(0x9a); // Fixed value for the tests.
-    std::uniform_int_distribution<IntType> distribution(std::numeric_limits<IntType>::min(), std::numeric_limits<IntType>::max());
-    for (int i = 0; i < 1000; ++i) {
-        const IntType value = distribution(engine);
+    std::uniform_int_distribution<int32_t> distribution(std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max());
+    std::vector<int32_t> values(count);
+    for (auto &value : values) {
+        value = distribution(engine);
+    }
+    std::vector<String> texts(count);
+    measure("String::number", count, "numbers", [&]() {
+        int64_t checksum = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            texts[i] = String::number(values[i]);
+            checksum += texts[i].getLength();
+        }
+        return checksum;
+    });
+    char buffer[16];
+    measure("snprintf", count, "numbers", [&]() {
+        int64_t checksum = 0;
+        for (const auto value : values) {
+            checksum += std::snprintf(buffer, sizeof(buffer), "%d", value);
+        }
+        return checksum;
+    });
+    measure("std::to_chars", count, "numbers", [&]() {
+        int64_t checksum = 0;
+        for (const auto value : values) {
+            checksum += std::to_chars(buffer, buffer + sizeof(buffer), value).ptr - buffer;
+        }
+        return checksum;
+    });
+    measure("String::toInt32", count, "numbers", [&]() {
+        int64_t checksum = 0;
+        for (const auto &text : texts) {
+            checksum += text.toInt32().getValue();
+        }
+        return checksum;
+    });
+    measure("strtol", count, "numbers", [&]() {
+        int64_t checksum = 0;
+        for (const auto &text : texts) {
+            checksum += std::strtol(text.getData(), nullptr, 10);
+        }
+        return checksum;
+    });
+    measure("std::from_chars", count, "numbers", [&]() {
+        int64_t checksum = 0;
+        for (const auto &text : texts) {
+            int32_t value = 0;
+            std::from_chars(text.getData(), text.getData() + text.getLength(), value);
+            checksum += value;
+        }
+        return checksum;
+    });
+}
+
+
+TEST(StringTest, StringToNumber64)
+{
+    testStringToNumber<String, int64_t>(&String::toInt64, "int64_t");
+    testStringToNumber<String, uint64_t>(&String::toUInt64, "uint64_t");
+    EXPECT_EQ(String("18446744073709551615").toUInt64().getValue(), std::numeric_limits<uint64_t>::max());
+    EXPECT_EQ(String("18446744073709551616").toUInt64().hasError(), true);
+    EXPECT_EQ(String("9223372036854775807").toInt64().getValue(), std::numeric_limits<int64_t>::max());
+    EXPECT_EQ(String("9223372036854775808").toInt64().hasError(), true);
+    EXPECT_EQ(String("-9223372036854775808").toInt64().getValue(), std::numeric_limits<int64_t>::min());
+    EXPECT_EQ(String("-9223372036854775809").toInt64().hasError(), true);
+    EXPECT_EQ(String("-1").toUInt64().hasError(), true);
+    EXPECT_EQ(String("99999999999999999999999").toUInt64().hasError(), true);
+    // Random values over the whole range, not just the low bits.
+    std::mt19937_64 engine(0x9a); // Fixed value for the tests.
+    for (int i = 0; i < 10000; ++i) {
+        const uint64_t value = engine() >> (i % 64);
+        const String unsignedStr = String::number(value);
+        ASSERT_EQ(std::string(unsignedStr.getData()), std::to_string(value));
+        ASSERT_EQ(unsignedStr.toUInt64().getValue(), value);
+        const auto signedValue = static_cast<int64_t>(value);
+        const String signedStr = String::number(signedValue);
+        ASSERT_EQ(std::string(signedStr.getData()), std::to_string(signedValue));
+        ASSERT_EQ(signedStr.toInt64().getValue(), signedValue);
+    }
+}
+
+
+// Floating point `std::to_chars` is missing in older standard libraries.
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+
+
+namespace {
+
+
+template<typename FloatType, typename BitsType>
+void floatingPointRoundTripTests(StatusResult<FloatType>(String::*memberFn)() const, const std::string &type)
+{
+    SCOPED_TRACE(std::string("Floating point round trip tests: ") + type);
+    std::mt19937_64 engine(0x9a); // Fixed value for the tests.
+    for (int i = 0; i < 100000; ++i) {
+        const auto bits = static_cast<BitsType>(engine());
+        FloatType value;
+        std::memcpy(&value, &bits, sizeof(value));
+        if (!std::isfinite(value)) {
+            continue;
+        }
+        char expected[40];
+        const auto expectedEnd = std::to_chars(expected, expected + sizeof(expected), value).ptr;
+        *expectedEnd = '\0';
+        SCOPED_TRACE(std::string("Value: ") + expected);
+        // The text is the shortest representation, which parses back to the same bits.
         const String valueStr = String::number(value);
-        std::ostringstream s;
-        s << "Value " << static_cast<int64_t>(value) << " Text '" << valueStr.getData() << "'";
-        SCOPED_TRACE(s.str());
-        result = (valueStr.*memberFn)();
-        EXPECT_EQ(result.isSuccess(), true);
-        EXPECT_EQ(result.getValue(), value);
+        ASSERT_EQ(std::string(valueStr.getData()), std::string(expected));
+        const auto result = (valueStr.*memberFn)();
+        ASSERT_EQ(result.isSuccess(), true);
+        BitsType resultBits;
+        const FloatType resultValue = result.getValue();
+        std::memcpy(&resultBits, &resultValue, sizeof(resultBits));
+        ASSERT_EQ(resultBits, bits);
     }
 }
 
 
-TEST(StringTest, StringToNumber)
+}
+
+
+TEST(StringTest, FloatingPointRoundTrip)
+{
+    floatingPointRoundTripTests<float, uint32_t>(&String::toFloat, "float");
+    floatingPointRoundTripTests<double, uint64_t>(&String::toDouble, "double");
+}
+
+
+#endif // __cpp_lib_to_chars
+
+
+namespace {
+
+
+/// Set the numeric locale for the lifetime of this object.
+/// The previous locale is restored on destruction, also if a test returns early.
+///
+class ScopedNumericLocale
+{
+public:
+    explicit ScopedNumericLocale(const char *name)
+        : _previous(std::setlocale(LC_NUMERIC, nullptr)), _isAvailable(std::setlocale(LC_NUMERIC, name) != nullptr) {
+    }
+    ~ScopedNumericLocale() {
+        std::setlocale(LC_NUMERIC, _previous.c_str());
+    }
+    ScopedNumericLocale(const ScopedNumericLocale&) = delete;
+    ScopedNumericLocale& operator=(const ScopedNumericLocale&) = delete;
+    bool isAvailable() const { return _isAvailable; }
+
+private:
+    std::string _previous;
+    bool _isAvailable;
+};
+
+
+}
+
+
+TEST(StringTest, FloatingPointConversion)
+{
+    EXPECT_EQ(String::number(0.0), "0");
+    EXPECT_EQ(String::number(-0.0), "-0");
+    EXPECT_EQ(String::number(1.0), "1");
+    EXPECT_EQ(String::number(0.1), "0.1");
+    EXPECT_EQ(String::number(0.1f), "0.1");
+    EXPECT_EQ(String::number(-2.5), "-2.5");
+    EXPECT_EQ(String::number(1e100), "1e+100");
+    EXPECT_EQ(String::number(5e-324), "5e-324");
+    EXPECT_EQ(String::number(std::numeric_limits<double>::max()), "1.7976931348623157e+308");
+    EXPECT_EQ(String::number(std::numeric_limits<float>::max()), "3.4028235e+38");
+    EXPECT_EQ(String::number(std::numeric_limits<double>::infinity()), "inf");
+    EXPECT_EQ(String::number(-std::numeric_limits<double>::infinity()), "-inf");
+    EXPECT_EQ(String::number(std::numeric_limits<double>::quiet_NaN()), "nan");
+    EXPECT_EQ(String("0.1").toDouble().getValue(), 0.1);
+    EXPECT_EQ(String("0.1").toFloat().getValue(), 0.1f);
+    EXPECT_EQ(String("-12.5e-3").toDouble().getValue(), -12.5e-3);
+    EXPECT_EQ(String("1E3").toDouble().getValue(), 1000.0);
+    EXPECT_EQ(String("42").toDouble().getValue(), 42.0);
+    EXPECT_EQ(String("inf").toDouble().getValue(), std::numeric_limits<double>::infinity());
+    EXPECT_EQ(String("-inf").toFloat().getValue(), -std::numeric_limits<float>::infinity());
+    EXPECT_EQ(std::isnan(String("nan").toDouble().getValue()), true);
+    // Values out of range for the type.
+    EXPECT_EQ(String("1e400").toDouble().hasError(), true);
+    EXPECT_EQ(String("1e39").toFloat().hasError(), true);
+    EXPECT_EQ(String("1e39").toDouble().isSuccess(), true);
+    const char* const invalidTexts[] = {"", " ", "test", " 1.5", "1.5 ", "1.5x", "x1.5", "+1.5", "--1", "1e", "1,5", "0x10"};
+    for (const auto text : invalidTexts) {
+        SCOPED_TRACE(std::string("Text: \"") + text + "\"");
+        EXPECT_EQ(String(text).toDouble().hasError(), true);
+        EXPECT_EQ(String(text).toFloat().hasError(), true);
+    }
+    // The conversion does not depend on the locale.
+    const ScopedNumericLocale numericLocale("de_DE.UTF-8");
+    if (numericLocale.isAvailable()) {
+        EXPECT_EQ(String::number(1.5), "1.5");
+        EXPECT_EQ(String("1.5").toDouble().getValue(), 1.5);
+        EXPECT_EQ(String("1,5").toDouble().hasError(), true);
+    } else {
+        std::cout << "Locale de_DE.UTF-8 is not available, the locale test is skipped." << std::endl;
+    }
+}
+
+
+/// Compare the 64bit and floating point conversions with `snprintf`, `strtod` and `std::to_chars`/`std::from_chars`.
+///
+TEST(StringTest, DISABLED_BenchmarkNumberConversion64)
 {
-    stringToNumberTests<int8_t>(&String::toInt8, "int8_t");
-    stringToNumberTests<uint8_t>(&String::toUInt8, "uint8_t");
-    stringToNumberTests<int16_t>(&String::toInt16, "int16_t");
-    stringToNumberTests<uint16_t>(&String::toUInt16, "uint16_t");
-    stringToNumberTests<int32_t>(&String::toInt32, "int32_t");
-    stringToNumberTests<uint32_t>(&String::toUInt32, "uint32_t");
-}
\ No newline at end of file
+    const std::size_t count = 0x100000;
+    std::mt19937_64 engine(0x9a); // Fixed value for the tests.
+    std::uniform_real_distribution<double> distribution(-1e6, 1e6);
+    std::vector<uint64_t> integerValues(count);
+    std::vector<double> values(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        integerValues[i] = engine();
+        values[i] = distribution(engine);
+    }
+    std::vector<String> texts(count);
+    measure("String::number/toUInt64", count, "round trips", [&]() {
+        uint64_t checksum = 0;
+        for (const auto value : integerValues) {
+            checksum += String::number(value).toUInt64().getValue();
+        }
+        return checksum;
+    });
+    measure("String::number(double)", count, "numbers", [&]() {
+        uint64_t checksum = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            texts[i] = String::number(values[i]);
+            checksum += texts[i].getLength();
+        }
+        return checksum;
+    });
+    char buffer[40];
+    measure("snprintf", count, "numbers", [&]() {
+        uint64_t checksum = 0;
+        for (const auto value : values) {
+            checksum += std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+        }
+        return checksum;
+    });
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    measure("std::to_chars", count, "numbers", [&]() {
+        uint64_t checksum = 0;
+        for (const auto value : values) {
+            checksum += std::to_chars(buffer, buffer + sizeof(buffer), value).ptr - buffer;
+        }
+        return checksum;
+    });
+#endif
+    measure("String::toDouble", count, "numbers", [&]() {
+        double sum = 0.0;
+        for (const auto &text : texts) {
+            sum += text.toDouble().getValue();
+        }
+        return sum;
+    });
+    measure("strtod", count, "numbers", [&]() {
+        double sum = 0.0;
+        for (const auto &text : texts) {
+            sum += std::strtod(text.getData(), nullptr);
+        }
+        return sum;
+    });
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    measure("std::from_chars", count, "numbers", [&]() {
+        double sum = 0.0;
+        for (const auto &text : texts) {
+            double value = 0.0;
+            std::from_chars(text.getData(), text.getData() + text.getLength(), value);
+            sum += value;
+        }
+        return sum;
+    });
+#endif
+}
+
+
+namespace {
+
+
+template<typename IntType>
+void expectNumberInBaseLikeToChars(IntType value, int base)
+{
+    char expected[72];
+    const auto result = std::to_chars(expected, expected + sizeof(expected), value, base);
+    *result.ptr = '\0';
+    const String valueStr = (base == 16) ? String::numberHex(value) : String::numberBin(value);
+    ASSERT_EQ(std::string(valueStr.getData()), std::string(expected));
+    ASSERT_EQ(valueStr.getLength(), static_cast<String::Length>(result.ptr - expected));
+}
+
+
+}
+
+
+TEST(StringTest, NumberHex)
+{
+    EXPECT_EQ(String::numberHex(static_cast<uint8_t>(0)), "0");
+    EXPECT_EQ(String::numberHex(static_cast<uint8_t>(0xab)), "ab");
+    EXPECT_EQ(String::numberHex(static_cast<uint8_t>(0x0f), 2), "0f");
+    EXPECT_EQ(String::numberHex(static_cast<uint8_t>(0), 2), "00");
+    EXPECT_EQ(String::numberHex(static_cast<uint16_t>(0x1234)), "1234");
+    EXPECT_EQ(String::numberHex(static_cast<uint16_t>(0x12), 4), "0012");
+    EXPECT_EQ(String::numberHex(static_cast<uint32_t>(0xdeadbeef)), "deadbeef");
+    EXPECT_EQ(String::numberHex(static_cast<uint32_t>(0x1), 8), "00000001");
+    EXPECT_EQ(String::numberHex(std::numeric_limits<uint32_t>::max()), "ffffffff");
+    EXPECT_EQ(String::numberHex(static_cast<uint64_t>(0x0123456789abcdefull)), "123456789abcdef");
+    EXPECT_EQ(String::numberHex(static_cast<uint64_t>(0x0123456789abcdefull), 16), "0123456789abcdef");
+    EXPECT_EQ(String::numberHex(std::numeric_limits<uint64_t>::max()), "ffffffffffffffff");
+    // A width smaller than the number of digits never truncates the value.
+    EXPECT_EQ(String::numberHex(static_cast<uint32_t>(0x12345), 2), "12345");
+    // Every 8bit and 16bit value.
+    for (uint32_t value = 0; value <= std::numeric_limits<uint16_t>::max(); ++value) {
+        SCOPED_TRACE(std::string("Value: ") + std::to_string(value));
+        if (value <= std::numeric_limits<uint8_t>::max()) {
+            ASSERT_NO_FATAL_FAILURE(expectNumberInBaseLikeToChars<uint8_t>(static_cast<uint8_t>(value), 16));
+        }
+        ASSERT_NO_FATAL_FAILURE(expectNumberInBaseLikeToChars<uint16_t>(static_cast<uint16_t>(value), 16));
+    }
+    // Random values with and without a width.
+    std::mt19937_64 engine(0x9a); // Fixed value for the tests.
+    for (int i = 0; i < 10000; ++i) {
+        const uint64_t value = engine() >> (i % 64);
+        SCOPED_TRACE(std::string("Value: ") + std::to_string(value));
+        ASSERT_NO_FATAL_FAILURE(expectNumberInBaseLikeToChars<uint64_t>(value, 16));
+        ASSERT_NO_FATAL_FAILURE(expectNumberInBaseLikeToChars<uint32_t>(static_cast<uint32_t>(value), 16));
+        char expected[24];
+        std::snprintf(expected, sizeof(expected), "%08x", static_cast<uint32_t>(value));
+        ASSERT_EQ(std::string(String::numberHex(static_cast<uint32_t>(value), 8).getData()), std::string(expected));
+    }
+}
+
+
+TEST(StringTest, NumberBin)
+{
+    EXPECT_EQ(String::numberBin(static_cast<uint8_t>(0)), "0");
+    EXPECT_EQ(String::numberBin(static_cast<uint8_t>(0xa5)), "10100101");
+    EXPECT_EQ(String::numberBin(static_cast<uint8_t>(0x05), 8), "00000101");
+    EXPECT_EQ(String::numberBin(static_cast<uint16_t>(0x8001)), "1000000000000001");
+    EXPECT_EQ(String::numberBin(static_cast<uint32_t>(0x3), 4), "0011");
+    EXPECT_EQ(String::numberBin(static_cast<uint32_t>(0xff), 4), "11111111");
+    EXPECT_EQ(String::numberBin(std::numeric_limits<uint32_t>::max()), std::string(32, '1').c_str());
+    EXPECT_EQ(String::numberBin(std::numeric_limits<uint64_t>::max()), std::string(64, '1').c_str());
+    EXPECT_EQ(String::numberBin(static_cast<uint64_t>(1), 64), (std::string(63, '0') + "1").c_str());
+    for (uint32_t value = 0; value <= std::numeric_limits<uint16_t>::max(); ++value) {
+        SCOPED_TRACE(std::string("Value: ") + std::to_string(value));
+        if (value <= std::numeric_limits<uint8_t>::max()) {
+            ASSERT_NO_FATAL_FAILURE(expectNumberInBaseLikeToChars<uint8_t>(static_cast<uint8_t>(value), 2));
+        }
+        ASSERT_NO_FATAL_FAILURE(expectNumberInBaseLikeToChars<uint16_t>(static_cast<uint16_t>(value), 2));
+    }
+    std::mt19937_64 engine(0x9a); // Fixed value for the tests.
+    for (int i = 0; i < 10000; ++i) {
+        const uint64_t value = engine() >> (i % 64);
+        SCOPED_TRACE(std::string("Value: ") + std::to_string(value));
+        ASSERT_NO_FATAL_FAILURE(expectNumberInBaseLikeToChars<uint64_t>(value, 2));
+        ASSERT_NO_FATAL_FAILURE(expectNumberInBaseLikeToChars<uint32_t>(static_cast<uint32_t>(value), 2));
+    }
+}
+
+
+TEST(StringTest, StringToNumberWithBase)
+{
+    EXPECT_EQ(String("ff").toUInt32(16).getValue(), 0xffu);
+    EXPECT_EQ(String("FF").toUInt32(16).getValue(), 0xffu);
+    EXPECT_EQ(String("DeadBeef").toUInt32(16).getValue(), 0xdeadbeefu);
+    EXPECT_EQ(String("0000000000ffffffff").toUInt32(16).getValue(), 0xffffffffu);
+    EXPECT_EQ(String("100000000").toUInt32(16).hasError(), true);
+    EXPECT_EQ(String("10100101").toUInt32(2).getValue(), 0xa5u);
+    EXPECT_EQ(String(std::string(32, '1').c_str()).toUInt32(2).getValue(), 0xffffffffu);
+    EXPECT_EQ(String(("1" + std::string(32, '0')).c_str()).toUInt32(2).hasError(), true);
+    EXPECT_EQ(String("777").toUInt32(8).getValue(), 0777u);
+    EXPECT_EQ(String("z").toUInt32(36).getValue(), 35u);
+    EXPECT_EQ(String("12345").toUInt32(10).getValue(), String("12345").toUInt32().getValue());
+    // Invalid digits for the base.
+    const char* const invalidHexTexts[] = {"", " ", "0x10", "g", "1g", "-1", "+1", " ff", "ff ", "f f"};
+    for (const auto text : invalidHexTexts) {
+        SCOPED_TRACE(std::string("Text: \"") + text + "\"");
+        EXPECT_EQ(String(text).toUInt32(16).hasError(), true);
+    }
+    const char* const invalidBinTexts[] = {"", "2", "102", "1 0", "0b1", "a"};
+    for (const auto text : invalidBinTexts) {
+        SCOPED_TRACE(std::string("Text: \"") + text + "\"");
+        EXPECT_EQ(String(text).toUInt32(2).hasError(), true);
+    }
+    EXPECT_EQ(String("8").toUInt32(8).hasError(), true);
+    EXPECT_EQ(String("a").toUInt32(10).hasError(), true);
+    // Bases outside of 2-36 are rejected.
+    EXPECT_EQ(String("0").toUInt32(0).hasError(), true);
+    EXPECT_EQ(String("0").toUInt32(1).hasError(), true);
+    EXPECT_EQ(String("0").toUInt32(37).hasError(), true);
+    // Round trip of random values in every base.
+    std::mt19937_64 engine(0x9a); // Fixed value for the tests.
+    for (int base = 2; base <= 36; ++base) {
+        SCOPED_TRACE(std::string("Base: ") + std::to_string(base));
+        for (int i = 0; i < 1000; ++i) {
+            const auto value = static_cast<uint32_t>(engine() >> (i % 32));
+            char text[40];
+            *std::to_chars(text, text + sizeof(text), value, base).ptr = '\0';
+            SCOPED_TRACE(std::string("Text: ") + text);
+            const auto result = String(text).toUInt32(static_cast<uint8_t>(base));
+            ASSERT_EQ(result.isSuccess(), true);
+            ASSERT_EQ(result.getValue(), value);
+        }
+    }
+    // The formatted values parse back.
+    for (int i = 0; i < 10000; ++i) {
+        const auto value = static_cast<uint32_t>(engine());
+        ASSERT_EQ(String::numberHex(value, 8).toUInt32(16).getValue(), value);
+        ASSERT_EQ(String::numberBin(value).toUInt32(2).getValue(), value);
+    }
+}
+
+
+/// Compare the hex formatting with `snprintf` and `std::to_chars`, and the hex parsing with `strtoul`.
+///
+TEST(StringTest, DISABLED_BenchmarkNumberHex)
+{
+    const std::size_t count = 0x100000;
+    std::mt19937 engine(0x9a); // Fixed value for the tests.
+    std::vector<uint32_t> values(count);
+    for (auto &value : values) {
+        value = engine();
+    }
+    std::vector<String> texts(count);
+    measure("String::numberHex", count, "numbers", [&]() {
+        uint64_t checksum = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            texts[i] = String::numberHex(values[i], 8);
+            checksum += texts[i].getLength();
+        }
+        return checksum;
+    });
+    char buffer[24];
+    measure("snprintf", count, "numbers", [&]() {
+        uint64_t checksum = 0;
+        for (const auto value : values) {
+            checksum += std::snprintf(buffer, sizeof(buffer), "%08x", value);
+        }
+        return checksum;
+    });
+    measure("std::to_chars", count, "numbers", [&]() {
+        uint64_t checksum = 0;
+        for (const auto value : values) {
+            checksum += std::to_chars(buffer, buffer + sizeof(buffer), value, 16).ptr - buffer;
+        }
+        return checksum;
+    });
+    measure("String::toUInt32(16)", count, "numbers", [&]() {
+        uint64_t checksum = 0;
+        for (const auto &text : texts) {
+            checksum += text.toUInt32(16).getValue();
+        }
+        return checksum;
+    });
+    measure("strtoul", count, "numbers", [&]() {
+        uint64_t checksum = 0;
+        for (const auto &text : texts) {
+            checksum += std::strtoul(text.getData(), nullptr, 16);
+        }
+        return checksum;
+    });
+}
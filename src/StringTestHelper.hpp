@@ -0,0 +1,85 @@
+//
+// (c)2019 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+#pragma once
+
+
+#include "hal-common/String.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <type_traits>
+
+
+namespace lr::test {
+
+
+/// Test the conversion of a string or view into an integer.
+/// The random numbers are embedded in a longer text, to make sure the conversion
+/// does not read past the end of the string.
+///
+template<typename StringType, typename IntType>
+void testStringToNumber(StatusResult<IntType>(StringType::*memberFn)() const, const std::string &type)
+{
+    SCOPED_TRACE(std::string("String to number tests: ") + type);
+    const char* const invalidTexts[] = {"", "-", "  ", "test", " 12", "12 ", "x12", "1x2", "+12", "--1"};
+    for (const auto text : invalidTexts) {
+        SCOPED_TRACE(std::string("Text: \"") + text + "\"");
+        EXPECT_EQ(true, (StringType(text).*memberFn)().hasError());
+    }
+    EXPECT_EQ(0, (StringType("0").*memberFn)().getValue());
+    EXPECT_EQ(12, (StringType("12").*memberFn)().getValue());
+    const std::string maxText = std::to_string(std::numeric_limits<IntType>::max());
+    auto result = (StringType(maxText.c_str()).*memberFn)();
+    EXPECT_EQ(true, result.isSuccess());
+    EXPECT_EQ(std::numeric_limits<IntType>::max(), result.getValue());
+    const std::string minText = std::to_string(std::numeric_limits<IntType>::min());
+    result = (StringType(minText.c_str()).*memberFn)();
+    EXPECT_EQ(true, result.isSuccess());
+    EXPECT_EQ(std::numeric_limits<IntType>::min(), result.getValue());
+    // One above the maximum and one below the minimum.
+    if constexpr (sizeof(IntType) < sizeof(int64_t)) {
+        const std::string aboveText = std::to_string(static_cast<int64_t>(std::numeric_limits<IntType>::max()) + 1);
+        EXPECT_EQ(true, (StringType(aboveText.c_str()).*memberFn)().hasError());
+        const std::string belowText = std::to_string(static_cast<int64_t>(std::numeric_limits<IntType>::min()) - 1);
+        EXPECT_EQ(true, (StringType(belowText.c_str()).*memberFn)().hasError());
+    } else if constexpr (std::is_unsigned_v<IntType>) {
+        EXPECT_EQ(true, (StringType("-1").*memberFn)().hasError());
+    }
+    // Random numbers, embedded in a longer text.
+    using DistributionType = std::conditional_t<std::is_signed_v<IntType>, int64_t, uint64_t>;
+    std::ranlux24_base engine(0x9a); // Fixed value for the tests.
+    std::uniform_int_distribution<DistributionType> distribution(
+        std::numeric_limits<IntType>::min(), std::numeric_limits<IntType>::max());
+    for (int i = 0; i < 1000; ++i) {
+        const auto value = static_cast<IntType>(distribution(engine));
+        const std::string valueText = std::to_string(value);
+        const std::string text = valueText + "123";
+        SCOPED_TRACE(std::string("Value: ") + valueText);
+        result = (StringType(text.data(), static_cast<typename StringType::Length>(valueText.size())).*memberFn)();
+        ASSERT_EQ(true, result.isSuccess());
+        ASSERT_EQ(value, result.getValue());
+    }
+}
+
+
+}
+
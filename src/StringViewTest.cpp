@@ -0,0 +1,202 @@
+//
+// (c)2019 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+#include "StringTestHelper.hpp"
+
+#include "hal-common/StringView.hpp"
+
+#include "gtest/gtest.h"
+
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#pragma ide diagnostic ignored "cert-msc32-c"
+
+
+using lr::String;
+using lr::StringView;
+using lr::test::testStringToNumber;
+
+
+namespace {
+
+
+/// Split a text and collect the tokens as standard strings.
+///
+std::vector<std::string> splitToVector(const StringView &view, char separator)
+{
+    std::vector<std::string> result;
+    for (const auto token : view.split(separator)) {
+        result.emplace_back(token.getData(), token.getLength());
+    }
+    return result;
+}
+
+
+}
+
+
+/// Test creating views.
+///
+TEST(StringViewTest, Create)
+{
+    const StringView empty;
+    EXPECT_EQ(true, empty.isEmpty());
+    EXPECT_EQ(0, empty.getLength());
+    const auto literal = "string literal x";
+    const StringView fromLiteral(literal);
+    EXPECT_EQ(false, fromLiteral.isEmpty());
+    EXPECT_EQ(16, fromLiteral.getLength());
+    EXPECT_EQ(literal, fromLiteral.getData()); // no copy is made.
+    const StringView partial(literal, 6);
+    EXPECT_EQ(6, partial.getLength());
+    EXPECT_EQ(literal, partial.getData());
+    const String str("owned string");
+    const StringView fromString(str);
+    EXPECT_EQ(str.getData(), fromString.getData());
+    EXPECT_EQ(str.getLength(), fromString.getLength());
+    EXPECT_EQ(String("string"), partial.toString());
+}
+
+
+/// Test the comparison operators.
+///
+TEST(StringViewTest, Compare)
+{
+    const StringView a("first");
+    const StringView b("second");
+    EXPECT_EQ(false, (a == b));
+    EXPECT_EQ(true, (a != b));
+    EXPECT_EQ(true, (a < b));
+    EXPECT_EQ(true, (a <= b));
+    EXPECT_EQ(false, (a > b));
+    EXPECT_EQ(false, (a >= b));
+    EXPECT_EQ(true, (a == a));
+    EXPECT_EQ(false, (a < a));
+    EXPECT_EQ(true, (a <= a));
+    EXPECT_EQ(true, (a >= a));
+    // With literals.
+    EXPECT_EQ(true, (a == "first"));
+    EXPECT_EQ(false, (a == "hello"));
+    EXPECT_EQ(true, (a != "hello"));
+    EXPECT_EQ(true, (a < "second"));
+    EXPECT_EQ(true, (a <= "second"));
+    EXPECT_EQ(false, (a > "second"));
+    EXPECT_EQ(false, (a >= "second"));
+    // Prefixes compare by length, without a terminating zero.
+    const StringView prefix("firstsecond", 5);
+    EXPECT_EQ(true, (prefix == a));
+    EXPECT_EQ(true, (prefix == "first"));
+    EXPECT_EQ(true, (prefix < "firsts"));
+    EXPECT_EQ(true, (StringView("firsts") > prefix));
+    EXPECT_EQ(true, (StringView() == ""));
+    EXPECT_EQ(true, (StringView() < prefix));
+    // With owned strings.
+    EXPECT_EQ(true, (StringView(String("first")) == a));
+}
+
+
+/// Test the conversion into numbers.
+///
+TEST(StringViewTest, ViewToNumber)
+{
+    testStringToNumber<StringView, int8_t>(&StringView::toInt8, "int8_t");
+    testStringToNumber<StringView, uint8_t>(&StringView::toUInt8, "uint8_t");
+    testStringToNumber<StringView, int16_t>(&StringView::toInt16, "int16_t");
+    testStringToNumber<StringView, uint16_t>(&StringView::toUInt16, "uint16_t");
+    testStringToNumber<StringView, int32_t>(&StringView::toInt32, "int32_t");
+    testStringToNumber<StringView, uint32_t>(&StringView::toUInt32, "uint32_t");
+    EXPECT_EQ(true, StringView("-1").toUInt32().hasError());
+}
+
+
+/// Test splitting a view into tokens.
+///
+TEST(StringViewTest, Split)
+{
+    EXPECT_EQ(std::vector<std::string>({"a", "b", "c"}), splitToVector("a,b,c", ','));
+    EXPECT_EQ(std::vector<std::string>({"abc"}), splitToVector("abc", ','));
+    EXPECT_EQ(std::vector<std::string>({""}), splitToVector("", ','));
+    EXPECT_EQ(std::vector<std::string>({"", ""}), splitToVector(",", ','));
+    EXPECT_EQ(std::vector<std::string>({"a", "", "b", ""}), splitToVector("a,,b,", ','));
+    EXPECT_EQ(std::vector<std::string>({"", "a"}), splitToVector(",a", ','));
+    // The separator after the end of the view is ignored.
+    EXPECT_EQ(std::vector<std::string>({"a", "b"}), splitToVector(StringView("a b c", 3), ' '));
+    // Tokens point into the original buffer.
+    const char* const text = "set 12 -34";
+    std::size_t index = 0;
+    const std::size_t expectedOffsets[] = {0, 4, 7};
+    for (const auto token : StringView(text).split(' ')) {
+        ASSERT_LT(index, 3u);
+        EXPECT_EQ(text + expectedOffsets[index], token.getData());
+        ++index;
+    }
+    EXPECT_EQ(3u, index);
+}
+
+
+/// Test parsing a command line without creating owned strings.
+///
+TEST(StringViewTest, ParseCommand)
+{
+    const String command("move 120 -45 7");
+    auto tokens = StringView(command).split(' ');
+    auto it = tokens.begin();
+    ASSERT_NE(tokens.end(), it);
+    EXPECT_EQ(true, (*it == "move"));
+    ++it;
+    ASSERT_NE(tokens.end(), it);
+    EXPECT_EQ(120, (*it).toUInt16().getValue());
+    ++it;
+    ASSERT_NE(tokens.end(), it);
+    EXPECT_EQ(-45, (*it).toInt8().getValue());
+    ++it;
+    ASSERT_NE(tokens.end(), it);
+    EXPECT_EQ(7, (*it).toUInt32().getValue());
+    ++it;
+    EXPECT_EQ(tokens.end(), it);
+    // Random fields, compared with the conversion of owned strings.
+    std::ranlux24_base engine(0x56); // Fixed value for the tests.
+    std::uniform_int_distribution<int32_t> distribution(std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max());
+    for (int i = 0; i < 100; ++i) {
+        std::vector<int32_t> values(1 + i % 10);
+        String line;
+        for (std::size_t j = 0; j < values.size(); ++j) {
+            values[j] = distribution(engine);
+            if (j > 0) {
+                line.append(';');
+            }
+            line.append(String::number(values[j]));
+        }
+        std::size_t index = 0;
+        for (const auto token : StringView(line).split(';')) {
+            ASSERT_LT(index, values.size());
+            ASSERT_EQ(values[index], token.toInt32().getValue());
+            ASSERT_EQ(token.toString().toInt32().getValue(), token.toInt32().getValue());
+            ++index;
+        }
+        ASSERT_EQ(values.size(), index);
+    }
+}
+
+
+#pragma clang diagnostic pop
@@ -0,0 +1,252 @@
+//
+// (c)2019 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+#include "BenchmarkHelper.hpp"
+
+#include "hal-common/TimeSeriesIndex.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#pragma ide diagnostic ignored "cert-msc32-c"
+
+
+using lr::DateTime;
+using lr::TimeSeriesIndex;
+using lr::Timestamp32;
+using lr::Timestamp64;
+using lr::test::measure;
+
+
+namespace {
+
+
+/// Helper class to fill an index and a reference map with the same events.
+/// Most events are appended, some are inserted up to one hour in the past.
+///
+template<typename Timestamp>
+class IndexTestData
+{
+public:
+    using Index = TimeSeriesIndex<Timestamp, uint32_t>;
+    using Reference = std::multimap<uint64_t, uint32_t>;
+
+public:
+    explicit IndexTestData(uint32_t count)
+        : _firstValue(Timestamp(DateTime(2019, 1, 1)).getValue()), _lastValue(_firstValue)
+    {
+        std::ranlux24_base engine(0x56); // Fixed value for the tests.
+        std::uniform_int_distribution<uint32_t> stepDistribution(0, 120);
+        std::uniform_int_distribution<uint32_t> pastDistribution(0, 3600);
+        std::uniform_int_distribution<uint32_t> orderDistribution(0, 9);
+        uint64_t currentValue = _firstValue;
+        for (uint32_t i = 0; i < count; ++i) {
+            uint64_t value;
+            if (orderDistribution(engine) == 0) {
+                value = currentValue - std::min<uint64_t>(pastDistribution(engine), currentValue - _firstValue);
+            } else {
+                currentValue += stepDistribution(engine);
+                value = currentValue;
+            }
+            _index.insert(Timestamp(static_cast<decltype(Timestamp().getValue())>(value)), i);
+            _reference.emplace(value, i);
+        }
+        _lastValue = currentValue;
+    }
+
+    const Index &getIndex() const { return _index; }
+    const Reference &getReference() const { return _reference; }
+    uint64_t getFirstValue() const { return _firstValue; }
+    uint64_t getLastValue() const { return _lastValue; }
+
+private:
+    Index _index;
+    Reference _reference;
+    uint64_t _firstValue;
+    uint64_t _lastValue;
+};
+
+
+/// Compare the index with the reference map.
+///
+template<typename Timestamp>
+void testIndex(uint32_t count)
+{
+    SCOPED_TRACE(std::string("Count: ") + std::to_string(count));
+    const IndexTestData<Timestamp> data(count);
+    const auto &index = data.getIndex();
+    const auto &reference = data.getReference();
+    ASSERT_EQ(count, index.getCount());
+    ASSERT_EQ(count == 0, index.isEmpty());
+    // Iterate over all entries, equal timestamps keep the insertion order.
+    auto referenceIt = reference.begin();
+    for (const auto &entry : index) {
+        ASSERT_NE(reference.end(), referenceIt);
+        ASSERT_EQ(referenceIt->first, entry.timestamp.getValue());
+        ASSERT_EQ(referenceIt->second, entry.value);
+        ++referenceIt;
+    }
+    ASSERT_EQ(reference.end(), referenceIt);
+    // Query random windows, also outside of the stored range.
+    std::ranlux24_base engine(0x9a); // Fixed value for the tests.
+    std::uniform_int_distribution<uint64_t> startDistribution(data.getFirstValue() - 1000, data.getLastValue() + 1000);
+    std::uniform_int_distribution<uint64_t> lengthDistribution(0, 20000);
+    for (int i = 0; i < 2000; ++i) {
+        const uint64_t startValue = startDistribution(engine);
+        const uint64_t endValue = startValue + lengthDistribution(engine);
+        const DateTime start = Timestamp64(startValue).toDateTime();
+        const DateTime end = Timestamp64(endValue).toDateTime();
+        // Lower bound.
+        const auto lowerBound = index.lowerBound(start);
+        const auto referenceLowerBound = reference.lower_bound(startValue);
+        if (referenceLowerBound == reference.end()) {
+            ASSERT_EQ(index.end(), lowerBound);
+        } else {
+            ASSERT_NE(index.end(), lowerBound);
+            ASSERT_EQ(referenceLowerBound->first, lowerBound->timestamp.getValue());
+            ASSERT_EQ(referenceLowerBound->second, lowerBound->value);
+        }
+        // Range from start, including, to end, excluding.
+        referenceIt = referenceLowerBound;
+        const auto referenceEnd = reference.lower_bound(endValue);
+        std::size_t rangeCount = 0;
+        for (const auto &entry : index.range(start, end)) {
+            ASSERT_NE(referenceEnd, referenceIt);
+            ASSERT_EQ(referenceIt->first, entry.timestamp.getValue());
+            ASSERT_EQ(referenceIt->second, entry.value);
+            ++referenceIt;
+            ++rangeCount;
+        }
+        ASSERT_EQ(referenceEnd, referenceIt);
+        ASSERT_EQ(rangeCount, index.range(start, end).getCount());
+    }
+}
+
+
+}
+
+
+/// Test an empty index.
+///
+TEST(TimeSeriesIndexTest, Empty)
+{
+    TimeSeriesIndex<Timestamp64, uint32_t> index;
+    EXPECT_EQ(0, index.getCount());
+    EXPECT_EQ(true, index.isEmpty());
+    EXPECT_EQ(index.end(), index.begin());
+    EXPECT_EQ(index.end(), index.lowerBound(DateTime()));
+    EXPECT_EQ(0, index.range(DateTime(), DateTime(9999, 12, 31, 23, 59, 59)).getCount());
+}
+
+
+/// Test inserting a few events and the limits of the queries.
+///
+TEST(TimeSeriesIndexTest, InsertAndQuery)
+{
+    TimeSeriesIndex<Timestamp64, uint32_t> index;
+    index.insert(Timestamp64(DateTime(2019, 4, 11, 12, 0, 0)), 1);
+    index.insert(Timestamp64(DateTime(2019, 4, 11, 13, 0, 0)), 2);
+    index.insert(Timestamp64(DateTime(2019, 4, 11, 12, 30, 0)), 3); // out of order
+    index.insert(Timestamp64(DateTime(2019, 4, 11, 13, 0, 0)), 4); // same time
+    EXPECT_EQ(4, index.getCount());
+    EXPECT_EQ(false, index.isEmpty());
+    const uint32_t expectedOrder[] = {1, 3, 2, 4};
+    std::size_t position = 0;
+    for (const auto &entry : index) {
+        ASSERT_LT(position, 4u);
+        EXPECT_EQ(expectedOrder[position], entry.value);
+        ++position;
+    }
+    EXPECT_EQ(4u, position);
+    // The first entry at or after the given time.
+    EXPECT_EQ(1, index.lowerBound(DateTime(2019, 4, 11, 11, 59, 59))->value);
+    EXPECT_EQ(1, index.lowerBound(DateTime(2019, 4, 11, 12, 0, 0))->value);
+    EXPECT_EQ(3, index.lowerBound(DateTime(2019, 4, 11, 12, 0, 1))->value);
+    EXPECT_EQ(2, index.lowerBound(DateTime(2019, 4, 11, 13, 0, 0))->value);
+    EXPECT_EQ(index.end(), index.lowerBound(DateTime(2019, 4, 11, 13, 0, 1)));
+    // The end of a range is excluded.
+    EXPECT_EQ(2, index.range(DateTime(2019, 4, 11, 12, 0, 0), DateTime(2019, 4, 11, 13, 0, 0)).getCount());
+    EXPECT_EQ(4, index.range(DateTime(2019, 4, 11, 12, 0, 0), DateTime(2019, 4, 11, 13, 0, 1)).getCount());
+    EXPECT_EQ(0, index.range(DateTime(2019, 4, 11, 12, 0, 0), DateTime(2019, 4, 11, 12, 0, 0)).getCount());
+    // A reversed range is empty.
+    EXPECT_EQ(0, index.range(DateTime(2019, 4, 11, 13, 0, 0), DateTime(2019, 4, 11, 12, 0, 0)).getCount());
+    index.clear();
+    EXPECT_EQ(true, index.isEmpty());
+}
+
+
+/// Compare indexes of various sizes with a reference map.
+///
+TEST(TimeSeriesIndexTest, CompareWithReference)
+{
+    const uint32_t counts[] = {1, 2, 15, 16, 17, 100, 1000, 100000};
+    for (const auto count : counts) {
+        testIndex<Timestamp64>(count);
+        testIndex<Timestamp32>(count);
+    }
+}
+
+
+/// Compare the speed of range queries with a `std::multimap`.
+///
+TEST(TimeSeriesIndexTest, DISABLED_BenchmarkRangeQueries)
+{
+    const uint32_t count = 0x400000;
+    const int queryCount = 0x100000;
+    const IndexTestData<Timestamp64> data(count);
+    std::ranlux24_base engine(0x9a); // Fixed value for the tests.
+    std::uniform_int_distribution<uint64_t> startDistribution(data.getFirstValue(), data.getLastValue());
+    std::vector<uint64_t> startValues(queryCount);
+    std::vector<DateTime> startDateTimes(queryCount);
+    std::vector<DateTime> endDateTimes(queryCount);
+    const uint64_t windowLength = 3600;
+    for (int i = 0; i < queryCount; ++i) {
+        startValues[i] = startDistribution(engine);
+        startDateTimes[i] = Timestamp64(startValues[i]).toDateTime();
+        endDateTimes[i] = Timestamp64(startValues[i] + windowLength).toDateTime();
+    }
+    measure("TimeSeriesIndex", queryCount, "queries", [&]() {
+        uint64_t checksum = 0;
+        for (int i = 0; i < queryCount; ++i) {
+            for (const auto &entry : data.getIndex().range(startDateTimes[i], endDateTimes[i])) {
+                checksum += entry.value;
+            }
+        }
+        return checksum;
+    });
+    measure("std::multimap", queryCount, "queries", [&]() {
+        uint64_t checksum = 0;
+        for (int i = 0; i < queryCount; ++i) {
+            const auto end = data.getReference().lower_bound(startValues[i] + windowLength);
+            for (auto it = data.getReference().lower_bound(startValues[i]); it != end; ++it) {
+                checksum += it->second;
+            }
+        }
+        return checksum;
+    });
+}
+
+
+#pragma clang diagnostic pop
@@ -0,0 +1,324 @@
+//
+// (c)2019 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+#include "BenchmarkHelper.hpp"
+
+#include "hal-common/TimeZone.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <ctime>
+#include <random>
+#include <string>
+#include <vector>
+
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#pragma ide diagnostic ignored "cert-msc32-c"
+
+
+using lr::DateTime;
+using lr::TimeZone;
+using lr::Timestamp32;
+using lr::Timestamp64;
+using lr::test::measure;
+
+
+namespace {
+
+
+/// Time zones to compare with the libc implementation.
+///
+const char* const cTimeZoneStrings[] = {
+    "UTC0",
+    "JST-9",
+    "IST-5:30",
+    "<+0545>-5:45",
+    "CET-1CEST,M3.5.0,M10.5.0/3",
+    "GMT0BST,M3.5.0/1,M10.5.0",
+    "EST5EDT,M3.2.0,M11.1.0",
+    "PST8PDT,M3.2.0,M11.1.0",
+    "AEST-10AEDT,M10.1.0,M4.1.0/3",
+    "NZST-12NZDT,M9.5.0,M4.1.0/3",
+    "<-03>3<-02>,M3.5.0/-2,M10.5.0/-1",
+    "IST-1GMT0,M10.5.0,M3.5.0/1",
+    "XST3XDT,J60,J300/1",
+    "XST3XDT,59,299/1",
+};
+
+
+/// Set the `TZ` environment variable for the lifetime of this object.
+/// The previous value is restored on destruction, also if a test returns early.
+///
+class ScopedTimeZoneEnvironment
+{
+public:
+    explicit ScopedTimeZoneEnvironment(const char *text) {
+        const char *previous = std::getenv("TZ");
+        _hadPrevious = (previous != nullptr);
+        if (_hadPrevious) {
+            _previous = previous;
+        }
+        setenv("TZ", text, 1);
+        tzset();
+    }
+    ~ScopedTimeZoneEnvironment() {
+        if (_hadPrevious) {
+            setenv("TZ", _previous.c_str(), 1);
+        } else {
+            unsetenv("TZ");
+        }
+        tzset();
+    }
+    ScopedTimeZoneEnvironment(const ScopedTimeZoneEnvironment&) = delete;
+    ScopedTimeZoneEnvironment& operator=(const ScopedTimeZoneEnvironment&) = delete;
+
+private:
+    bool _hadPrevious;
+    std::string _previous;
+};
+
+
+/// Compare the local time of a time zone with the result from `localtime_r`.
+/// The `TZ` environment variable has to be set to the same time zone.
+///
+void expectLocalTime(const TimeZone &timeZone, uint64_t value)
+{
+    const Timestamp64 timestamp(value);
+    const std::time_t unixTime = timestamp.toUnixTimestamp();
+    std::tm localDate = {};
+    localtime_r(&unixTime, &localDate);
+    ASSERT_EQ(localDate.tm_gmtoff, timeZone.getOffset(timestamp));
+    ASSERT_EQ(localDate.tm_isdst > 0, timeZone.isDaylightSaving(timestamp));
+    const DateTime expected(
+        localDate.tm_year + 1900,
+        localDate.tm_mon + 1,
+        localDate.tm_mday,
+        localDate.tm_hour,
+        localDate.tm_min,
+        localDate.tm_sec);
+    ASSERT_EQ(expected, timeZone.toLocalDateTime(timestamp));
+    if (value <= 0xffffffffull) {
+        const Timestamp32 timestamp32(static_cast<uint32_t>(value));
+        ASSERT_EQ(localDate.tm_gmtoff, timeZone.getOffset(timestamp32));
+        ASSERT_EQ(expected, timeZone.toLocalDateTime(timestamp32));
+    }
+}
+
+
+}
+
+
+/// Test the default time zone, which is UTC.
+///
+TEST(TimeZoneTest, DefaultIsUtc)
+{
+    const TimeZone timeZone;
+    EXPECT_EQ(false, timeZone.hasDaylightSaving());
+    EXPECT_EQ(0, timeZone.getStandardOffset());
+    Timestamp32 transitions[2];
+    EXPECT_EQ(0, timeZone.getTransitions(2019, transitions));
+    std::ranlux24_base engine(0x56); // Fixed value for the tests.
+    std::uniform_int_distribution<uint64_t> valueDistribution(0, 0x100000000ull);
+    for (int i = 0; i < 1000; ++i) {
+        const Timestamp64 timestamp(valueDistribution(engine));
+        ASSERT_EQ(0, timeZone.getOffset(timestamp));
+        ASSERT_EQ(false, timeZone.isDaylightSaving(timestamp));
+        ASSERT_EQ(timestamp.toDateTime(), timeZone.toLocalDateTime(timestamp));
+    }
+}
+
+
+/// Test parsing of POSIX time zone strings.
+///
+TEST(TimeZoneTest, FromPosixString)
+{
+    auto result = TimeZone::fromPosixString("CET-1CEST,M3.5.0,M10.5.0/3");
+    ASSERT_EQ(true, result.isSuccess());
+    auto timeZone = result.getValue();
+    EXPECT_EQ(true, timeZone.hasDaylightSaving());
+    EXPECT_EQ(3600, timeZone.getStandardOffset());
+    EXPECT_EQ(7200, timeZone.getDaylightSavingOffset());
+    result = TimeZone::fromPosixString("<+0545>-5:45");
+    ASSERT_EQ(true, result.isSuccess());
+    timeZone = result.getValue();
+    EXPECT_EQ(false, timeZone.hasDaylightSaving());
+    EXPECT_EQ(20700, timeZone.getStandardOffset());
+    result = TimeZone::fromPosixString("PST8PDT,M3.2.0,M11.1.0");
+    ASSERT_EQ(true, result.isSuccess());
+    timeZone = result.getValue();
+    EXPECT_EQ(-28800, timeZone.getStandardOffset());
+    EXPECT_EQ(-25200, timeZone.getDaylightSavingOffset());
+}
+
+
+/// Test if invalid POSIX time zone strings are rejected.
+///
+TEST(TimeZoneTest, FromPosixStringInvalid)
+{
+    const char* const invalidStrings[] = {
+        "",
+        "C",
+        "CET",
+        "CET-",
+        "CET-1 ",
+        "CET-1:60",
+        "<+01-1",
+        "CET-1CEST,M3.5.0",
+        "CET-1CEST,M3.5.0,",
+        "CET-1CEST,M13.5.0,M10.5.0/3",
+        "CET-1CEST,M3.6.0,M10.5.0/3",
+        "CET-1CEST,M3.5.7,M10.5.0/3",
+        "CET-1CEST,M3.5.0,M10.5.0/",
+        "CET-1CEST,J0,J300",
+        "CET-1CEST,J366,J300",
+        "CET-1CEST,366,300",
+        "CET-1CEST,X,Y",
+        "CET-1CEST,M3.5.0,M10.5.0/3,",
+    };
+    for (const auto text : invalidStrings) {
+        SCOPED_TRACE(std::string("Text: \"") + text + "\"");
+        EXPECT_EQ(true, TimeZone::fromPosixString(text).hasError());
+    }
+}
+
+
+/// Test the local time around the transitions of a well known time zone.
+///
+TEST(TimeZoneTest, TransitionsCet)
+{
+    const auto timeZone = TimeZone::fromPosixString("CET-1CEST,M3.5.0,M10.5.0/3").getValue();
+    Timestamp32 transitions[2];
+    ASSERT_EQ(2, timeZone.getTransitions(2019, transitions));
+    EXPECT_EQ(Timestamp32(DateTime(2019, 3, 31, 1, 0, 0)), transitions[0]);
+    EXPECT_EQ(Timestamp32(DateTime(2019, 10, 27, 1, 0, 0)), transitions[1]);
+    EXPECT_EQ(DateTime(2019, 3, 31, 1, 59, 59), timeZone.toLocalDateTime(Timestamp64(DateTime(2019, 3, 31, 0, 59, 59))));
+    EXPECT_EQ(DateTime(2019, 3, 31, 3, 0, 0), timeZone.toLocalDateTime(Timestamp64(DateTime(2019, 3, 31, 1, 0, 0))));
+    EXPECT_EQ(DateTime(2019, 10, 27, 2, 59, 59), timeZone.toLocalDateTime(Timestamp64(DateTime(2019, 10, 27, 0, 59, 59))));
+    EXPECT_EQ(DateTime(2019, 10, 27, 2, 0, 0), timeZone.toLocalDateTime(Timestamp64(DateTime(2019, 10, 27, 1, 0, 0))));
+    // In the southern hemisphere, the daylight saving time spans the new year.
+    const auto southTimeZone = TimeZone::fromPosixString("AEST-10AEDT,M10.1.0,M4.1.0/3").getValue();
+    ASSERT_EQ(2, southTimeZone.getTransitions(2019, transitions));
+    EXPECT_EQ(Timestamp32(DateTime(2019, 4, 6, 16, 0, 0)), transitions[0]);
+    EXPECT_EQ(Timestamp32(DateTime(2019, 10, 5, 16, 0, 0)), transitions[1]);
+    EXPECT_EQ(true, southTimeZone.isDaylightSaving(Timestamp64(DateTime(2019, 1, 1, 0, 0, 0))));
+    EXPECT_EQ(false, southTimeZone.isDaylightSaving(Timestamp64(DateTime(2019, 7, 1, 0, 0, 0))));
+}
+
+
+/// Test the day of year rules in a leap year and in a non-leap year.
+/// The zero based `n` form counts February 29, the `Jn` form never does.
+///
+TEST(TimeZoneTest, TransitionsDayOfYear)
+{
+    const auto zeroBased = TimeZone::fromPosixString("XST3XDT,59,299/1").getValue();
+    Timestamp32 transitions[2];
+    ASSERT_EQ(2, zeroBased.getTransitions(2019, transitions));
+    EXPECT_EQ(Timestamp32(DateTime(2019, 3, 1, 5, 0, 0)), transitions[0]);
+    EXPECT_EQ(Timestamp32(DateTime(2019, 10, 27, 3, 0, 0)), transitions[1]);
+    ASSERT_EQ(2, zeroBased.getTransitions(2020, transitions));
+    EXPECT_EQ(Timestamp32(DateTime(2020, 2, 29, 5, 0, 0)), transitions[0]);
+    EXPECT_EQ(Timestamp32(DateTime(2020, 10, 26, 3, 0, 0)), transitions[1]);
+    const auto julian = TimeZone::fromPosixString("XST3XDT,J60,J300/1").getValue();
+    ASSERT_EQ(2, julian.getTransitions(2019, transitions));
+    EXPECT_EQ(Timestamp32(DateTime(2019, 3, 1, 5, 0, 0)), transitions[0]);
+    EXPECT_EQ(Timestamp32(DateTime(2019, 10, 27, 3, 0, 0)), transitions[1]);
+    ASSERT_EQ(2, julian.getTransitions(2020, transitions));
+    EXPECT_EQ(Timestamp32(DateTime(2020, 3, 1, 5, 0, 0)), transitions[0]);
+    EXPECT_EQ(Timestamp32(DateTime(2020, 10, 27, 3, 0, 0)), transitions[1]);
+}
+
+
+/// Compare the local time with the libc implementation.
+///
+TEST(TimeZoneTest, CompareWithLibc)
+{
+    std::ranlux24_base engine(0x56); // Fixed value for the tests.
+    // Start one day after the epoch, so the local time of zones west of UTC is not in 1999.
+    const uint64_t firstValue = 86400;
+    const uint64_t lastValue = Timestamp64(DateTime(2099, 12, 31, 23, 59, 59)).getValue();
+    std::uniform_int_distribution<uint64_t> valueDistribution(firstValue, lastValue);
+    for (const auto text : cTimeZoneStrings) {
+        SCOPED_TRACE(std::string("Time zone: ") + text);
+        const auto result = TimeZone::fromPosixString(text);
+        ASSERT_EQ(true, result.isSuccess());
+        const auto timeZone = result.getValue();
+        const ScopedTimeZoneEnvironment timeZoneEnvironment(text);
+        for (int i = 0; i < 10000; ++i) {
+            ASSERT_NO_FATAL_FAILURE(expectLocalTime(timeZone, valueDistribution(engine)));
+        }
+        // Test the seconds around each transition.
+        for (uint16_t year = 2000; year < 2100; ++year) {
+            SCOPED_TRACE(std::string("Year: ") + std::to_string(year));
+            Timestamp32 transitions[2];
+            const auto transitionCount = timeZone.getTransitions(year, transitions);
+            ASSERT_EQ(timeZone.hasDaylightSaving() ? 2 : 0, transitionCount);
+            for (uint8_t i = 0; i < transitionCount; ++i) {
+                const uint64_t value = transitions[i].getValue();
+                if (value - 1 < firstValue) {
+                    continue;
+                }
+                ASSERT_NE(timeZone.getOffset(Timestamp64(value - 1)), timeZone.getOffset(Timestamp64(value)));
+                ASSERT_NO_FATAL_FAILURE(expectLocalTime(timeZone, value - 1));
+                ASSERT_NO_FATAL_FAILURE(expectLocalTime(timeZone, value));
+            }
+            if (transitionCount == 2) {
+                ASSERT_LT(transitions[0].getValue(), transitions[1].getValue());
+            }
+        }
+    }
+}
+
+
+/// Compare the speed of the local time conversion with `localtime_r`.
+///
+TEST(TimeZoneTest, DISABLED_BenchmarkToLocalDateTime)
+{
+    const char* const text = "CET-1CEST,M3.5.0,M10.5.0/3";
+    const auto timeZone = TimeZone::fromPosixString(text).getValue();
+    std::ranlux24_base engine(0x56); // Fixed value for the tests.
+    const uint64_t lastValue = Timestamp64(DateTime(2099, 12, 31, 23, 59, 59)).getValue();
+    std::uniform_int_distribution<uint64_t> valueDistribution(0, lastValue);
+    const std::size_t count = 0x100000;
+    std::vector<uint64_t> values(count);
+    for (auto &value : values) {
+        value = valueDistribution(engine);
+    }
+    measure("TimeZone::toLocalDateTime", count, "conversions", [&]() {
+        uint64_t checksum = 0;
+        for (const auto value : values) {
+            checksum += timeZone.toLocalDateTime(Timestamp64(value)).getHour();
+        }
+        return checksum;
+    });
+    const ScopedTimeZoneEnvironment timeZoneEnvironment(text);
+    measure("localtime_r", count, "conversions", [&]() {
+        uint64_t checksum = 0;
+        for (const auto value : values) {
+            const std::time_t unixTime = Timestamp64(value).toUnixTimestamp();
+            std::tm localDate = {};
+            localtime_r(&unixTime, &localDate);
+            checksum += localDate.tm_hour;
+        }
+        return checksum;
+    });
+}
+
+
+#pragma clang diagnostic pop
@@ -0,0 +1,226 @@
+//
+// (c)2019 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+#include "BenchmarkHelper.hpp"
+
+#include "hal-common/TimestampBatch.hpp"
+
+#include "gtest/gtest.h"
+
+#include <limits>
+#include <random>
+#include <vector>
+
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+#pragma ide diagnostic ignored "cert-msc32-c"
+
+
+using lr::DateTime;
+using lr::Timestamp32;
+using lr::Timestamp64;
+using lr::TimestampBatch::DateTimeFields;
+using lr::test::measure;
+
+
+namespace {
+
+
+/// Storage for the separate arrays of the date/time fields.
+///
+struct DateTimeArrays
+{
+    explicit DateTimeArrays(std::size_t count)
+        : years(count), months(count), days(count), hours(count), minutes(count), seconds(count)
+    {
+    }
+
+    DateTimeFields getFields()
+    {
+        return DateTimeFields({years.data(), months.data(), days.data(), hours.data(), minutes.data(), seconds.data()});
+    }
+
+    DateTime getDateTime(std::size_t index) const
+    {
+        return DateTime(years[index], months[index], days[index], hours[index], minutes[index], seconds[index]);
+    }
+
+    void setDateTime(std::size_t index, const DateTime &dateTime)
+    {
+        years[index] = dateTime.getYear();
+        months[index] = dateTime.getMonth();
+        days[index] = dateTime.getDay();
+        hours[index] = dateTime.getHour();
+        minutes[index] = dateTime.getMinute();
+        seconds[index] = dateTime.getSecond();
+    }
+
+    std::vector<uint16_t> years;
+    std::vector<uint8_t> months;
+    std::vector<uint8_t> days;
+    std::vector<uint8_t> hours;
+    std::vector<uint8_t> minutes;
+    std::vector<uint8_t> seconds;
+};
+
+
+/// Create random timestamps in the given range, including the limits.
+///
+template<typename Timestamp, typename Value>
+std::vector<Timestamp> createTimestamps(std::size_t count, Value maximum)
+{
+    std::ranlux24_base engine(0x56); // Fixed value for the tests.
+    std::uniform_int_distribution<Value> distribution(0, maximum);
+    std::vector<Timestamp> result;
+    result.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (i == 0) {
+            result.emplace_back(static_cast<Value>(0));
+        } else if (i == 1) {
+            result.emplace_back(maximum);
+        } else {
+            result.emplace_back(distribution(engine));
+        }
+    }
+    return result;
+}
+
+
+/// Compare the batch conversions with the conversion of single values.
+///
+template<typename Timestamp, typename Value>
+void testBatchConversion(Value maximum)
+{
+    const std::size_t counts[] = {0, 1, 2, 3, 7, 8, 9, 31, 32, 33, 1000, 0x10000};
+    for (const auto count : counts) {
+        SCOPED_TRACE(std::string("Count: ") + std::to_string(count));
+        const auto timestamps = createTimestamps<Timestamp, Value>(count, maximum);
+        // Timestamps to date/time fields.
+        DateTimeArrays arrays(count);
+        lr::TimestampBatch::toDateTimeFields(timestamps.data(), count, arrays.getFields());
+        for (std::size_t i = 0; i < count; ++i) {
+            ASSERT_EQ(timestamps[i].toDateTime(), arrays.getDateTime(i));
+        }
+        // Date/time fields back to timestamps.
+        std::vector<Timestamp> results(count);
+        lr::TimestampBatch::fromDateTimeFields(arrays.getFields(), count, results.data());
+        for (std::size_t i = 0; i < count; ++i) {
+            ASSERT_EQ(timestamps[i].getValue(), results[i].getValue());
+            ASSERT_EQ(Timestamp(arrays.getDateTime(i)).getValue(), results[i].getValue());
+        }
+    }
+}
+
+
+}
+
+
+/// Test the batch conversion of 32bit timestamps.
+///
+TEST(TimestampBatchTest, Convert32)
+{
+    testBatchConversion<Timestamp32, uint32_t>(std::numeric_limits<uint32_t>::max());
+}
+
+
+/// Test the batch conversion of 64bit timestamps, up to the last supported date.
+///
+TEST(TimestampBatchTest, Convert64)
+{
+    const auto maximum = Timestamp64(DateTime(9999, 12, 31, 23, 59, 59)).getValue();
+    testBatchConversion<Timestamp64, uint64_t>(maximum);
+}
+
+
+/// Test the conversion of values at the end of months, years and leap days.
+///
+TEST(TimestampBatchTest, CalendarBoundaries)
+{
+    const DateTime dateTimes[] = {
+        DateTime(2000, 1, 1, 0, 0, 0),
+        DateTime(2000, 2, 28, 23, 59, 59),
+        DateTime(2000, 2, 29, 0, 0, 0),
+        DateTime(2000, 2, 29, 23, 59, 59),
+        DateTime(2000, 3, 1, 0, 0, 0),
+        DateTime(2000, 12, 31, 23, 59, 59),
+        DateTime(2001, 1, 1, 0, 0, 0),
+        DateTime(2019, 4, 11, 12, 21, 13),
+        DateTime(2100, 2, 28, 23, 59, 59),
+        DateTime(2100, 3, 1, 0, 0, 0),
+        DateTime(2400, 2, 29, 12, 0, 0),
+        DateTime(9999, 12, 31, 23, 59, 59),
+    };
+    const std::size_t count = sizeof(dateTimes)/sizeof(DateTime);
+    DateTimeArrays arrays(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        arrays.setDateTime(i, dateTimes[i]);
+    }
+    std::vector<Timestamp64> timestamps(count);
+    lr::TimestampBatch::fromDateTimeFields(arrays.getFields(), count, timestamps.data());
+    DateTimeArrays results(count);
+    lr::TimestampBatch::toDateTimeFields(timestamps.data(), count, results.getFields());
+    for (std::size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(Timestamp64(dateTimes[i]).getValue(), timestamps[i].getValue());
+        EXPECT_EQ(dateTimes[i], results.getDateTime(i));
+    }
+}
+
+
+/// Compare the speed of the batch conversion with single conversions.
+///
+TEST(TimestampBatchTest, DISABLED_BenchmarkConversion)
+{
+    const std::size_t count = 0x100000;
+    const int repeatCount = 10;
+    const auto timestamps = createTimestamps<Timestamp32, uint32_t>(count, std::numeric_limits<uint32_t>::max());
+    DateTimeArrays arrays(count);
+    std::vector<DateTime> dateTimes(count);
+    std::vector<Timestamp32> results(count);
+    const auto valueCount = static_cast<double>(count * repeatCount);
+    measure("Scalar toDateTime()", valueCount, "values", [&]() {
+        for (int repeat = 0; repeat < repeatCount; ++repeat) {
+            for (std::size_t i = 0; i < count; ++i) {
+                dateTimes[i] = timestamps[i].toDateTime();
+            }
+        }
+        return dateTimes.back().getDay();
+    });
+    measure("Batch toDateTimeFields()", valueCount, "values", [&]() {
+        for (int repeat = 0; repeat < repeatCount; ++repeat) {
+            lr::TimestampBatch::toDateTimeFields(timestamps.data(), count, arrays.getFields());
+        }
+        return arrays.getDateTime(count - 1).getDay();
+    });
+    measure("Scalar Timestamp32(dateTime)", valueCount, "values", [&]() {
+        for (int repeat = 0; repeat < repeatCount; ++repeat) {
+            for (std::size_t i = 0; i < count; ++i) {
+                results[i] = Timestamp32(dateTimes[i]);
+            }
+        }
+        return results.back().getValue();
+    });
+    measure("Batch fromDateTimeFields()", valueCount, "values", [&]() {
+        for (int repeat = 0; repeat < repeatCount; ++repeat) {
+            lr::TimestampBatch::fromDateTimeFields(arrays.getFields(), count, results.data());
+        }
+        return results.back().getValue();
+    });
+}
+
+
+#pragma clang diagnostic pop
@@ -15,13 +15,16 @@
 // with this program; if not, write to the Free Software Foundation, Inc.,
 // 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 //
+#include "BenchmarkHelper.hpp"
+
 #include "hal-common/DateTime.hpp"
 #include "hal-common/Timestamp.hpp"
 
 #include "gtest/gtest.h"
 
 #include <ctime>
-#include <iostream>
+#include <random>
+#include <string>
 
 
 #pragma clang diagnostic push
@@ -32,6 +35,9 @@
 using lr::DateTime;
 using lr::Timestamp32;
 using lr::Timestamp64;
+using lr::TimestampMs64;
+using lr::TimestampNs64;
+using lr::test::measure;
 
 
 /// Test adding seconds using the 32bit Timestamp.
@@ -191,5 +197,287 @@ TEST(TimestampTest, GetSecondDelta)
 }
 
 
+/// Helper method to compare a converted date/time with the C++ standard library.
+///
+template<typename Timestamp>
+void expectDateTimeFromUnix(const Timestamp &timestamp)
+{
+    const std::time_t unixTime = static_cast<std::time_t>(timestamp.toUnixTimestamp());
+    std::tm expectedDate = {};
+    gmtime_r(&unixTime, &expectedDate);
+    const DateTime dateTime = timestamp.toDateTime();
+    ASSERT_EQ(expectedDate.tm_year + 1900, dateTime.getYear()) << "Timestamp: " << timestamp.getValue();
+    ASSERT_EQ(expectedDate.tm_mon + 1, dateTime.getMonth()) << "Timestamp: " << timestamp.getValue();
+    ASSERT_EQ(expectedDate.tm_mday, dateTime.getDay()) << "Timestamp: " << timestamp.getValue();
+    ASSERT_EQ(expectedDate.tm_hour, dateTime.getHour()) << "Timestamp: " << timestamp.getValue();
+    ASSERT_EQ(expectedDate.tm_min, dateTime.getMinute()) << "Timestamp: " << timestamp.getValue();
+    ASSERT_EQ(expectedDate.tm_sec, dateTime.getSecond()) << "Timestamp: " << timestamp.getValue();
+}
+
+
+/// Test the conversion of random 32bit timestamps to date/time.
+///
+TEST(TimestampTest, ToDateTimeRandom32)
+{
+    static_assert(sizeof(std::time_t) >= 8, "This test requires 64bit time_t.");
+    std::ranlux24_base engine(0x56); // Fixed value for the tests.
+    std::uniform_int_distribution<uint32_t> distribution;
+    ASSERT_NO_FATAL_FAILURE(expectDateTimeFromUnix(Timestamp32(0u)));
+    ASSERT_NO_FATAL_FAILURE(expectDateTimeFromUnix(Timestamp32(0xffffffffu)));
+    for (int i = 0; i < 100000; ++i) {
+        ASSERT_NO_FATAL_FAILURE(expectDateTimeFromUnix(Timestamp32(distribution(engine))));
+    }
+}
+
+
+/// Test the conversion of random 64bit timestamps to date/time.
+///
+TEST(TimestampTest, ToDateTimeRandom64)
+{
+    static_assert(sizeof(std::time_t) >= 8, "This test requires 64bit time_t.");
+    const auto lastValue = Timestamp64(DateTime(9999, 12, 31, 23, 59, 59)).getValue();
+    std::ranlux24_base engine(0x56); // Fixed value for the tests.
+    std::uniform_int_distribution<uint64_t> distribution(0, lastValue);
+    ASSERT_NO_FATAL_FAILURE(expectDateTimeFromUnix(Timestamp64(0ull)));
+    ASSERT_NO_FATAL_FAILURE(expectDateTimeFromUnix(Timestamp64(lastValue)));
+    for (int i = 0; i < 100000; ++i) {
+        ASSERT_NO_FATAL_FAILURE(expectDateTimeFromUnix(Timestamp64(distribution(engine))));
+    }
+}
+
+
+/// Test the first and last second of every day in the supported range.
+/// This covers all month ends, year ends and leap days.
+///
+TEST(TimestampTest, ToDateTimeEveryDay)
+{
+    const uint32_t secondsPerDay = 60*60*24;
+    for (uint32_t value = 0; value < (0xffffffffu - secondsPerDay); value += secondsPerDay) {
+        ASSERT_NO_FATAL_FAILURE(expectDateTimeFromUnix(Timestamp32(value)));
+        ASSERT_NO_FATAL_FAILURE(expectDateTimeFromUnix(Timestamp32(value + secondsPerDay - 1)));
+    }
+    const auto lastValue = Timestamp64(DateTime(9999, 12, 31, 23, 59, 59)).getValue();
+    for (uint64_t value = 0; value < lastValue; value += secondsPerDay) {
+        ASSERT_NO_FATAL_FAILURE(expectDateTimeFromUnix(Timestamp64(value)));
+        ASSERT_NO_FATAL_FAILURE(expectDateTimeFromUnix(Timestamp64(value + secondsPerDay - 1)));
+    }
+}
+
+
+/// Test if the conversion time does not depend on the distance from the epoch.
+///
+TEST(TimestampTest, DISABLED_BenchmarkToDateTime)
+{
+    const uint64_t secondsPerYear = 60ull*60ull*24ull*365ull;
+    const uint64_t yearOffsets[] = {0, 1, 10, 100, 1000, 7999};
+    const int iterations = 0x1000000;
+    for (const auto yearOffset : yearOffsets) {
+        const uint64_t startValue = yearOffset * secondsPerYear;
+        measure("Years from epoch " + std::to_string(yearOffset), iterations, "conversions", [&]() {
+            uint32_t checksum = 0;
+            for (int i = 0; i < iterations; ++i) {
+                checksum += Timestamp64(startValue + static_cast<uint64_t>(i) * 7u).toDateTime().getDay();
+            }
+            return checksum;
+        });
+    }
+}
+
+
+namespace {
+
+
+/// A schedule table, converted to timestamps at compile time.
+///
+constexpr DateTime cScheduleDateTimes[] = {
+    DateTime(2019, 1, 1, 6, 0, 0),
+    DateTime(2019, 6, 30, 12, 30, 0),
+    DateTime(2020, 2, 29, 23, 59, 59),
+    DateTime(2100, 3, 1, 0, 0, 0),
+};
+constexpr Timestamp32 cScheduleTimestamps[] = {
+    Timestamp32(cScheduleDateTimes[0]),
+    Timestamp32(cScheduleDateTimes[1]),
+    Timestamp32(cScheduleDateTimes[2]),
+    Timestamp32(cScheduleDateTimes[3]),
+};
+static_assert(cScheduleTimestamps[0].getValue() == 599637600u, "Unexpected timestamp.");
+static_assert(cScheduleTimestamps[1].getValue() == 615213000u, "Unexpected timestamp.");
+static_assert(cScheduleTimestamps[2].getValue() == 636335999u, "Unexpected timestamp.");
+static_assert(cScheduleTimestamps[3].getValue() == 3160857600u, "Unexpected timestamp.");
+
+
+}
+
+
+/// Test the conversion between date/time and timestamps at compile time.
+///
+TEST(TimestampTest, ConstexprConversion)
+{
+    constexpr DateTime custom(2019, 4, 11, 12, 21, 13);
+    constexpr Timestamp32 timestamp32(custom);
+    static_assert(timestamp32.getValue() == 608300473u, "Unexpected timestamp.");
+    static_assert(timestamp32.toUnixTimestamp() == 1554985273, "Unexpected unix timestamp.");
+    constexpr Timestamp64 timestamp64(custom);
+    static_assert(timestamp64.getValue() == 608300473ull, "Unexpected timestamp.");
+    static_assert(timestamp64.toUnixTimestamp() == 1554985273, "Unexpected unix timestamp.");
+    constexpr Timestamp64 last(DateTime(9999, 12, 31, 23, 59, 59));
+    static_assert(last.getValue() == 252455615999ull, "Unexpected timestamp.");
+
+    constexpr DateTime fromTimestamp32 = Timestamp32(608300473u).toDateTime();
+    static_assert(fromTimestamp32.getYear() == 2019, "Unexpected year.");
+    static_assert(fromTimestamp32.getMonth() == 4, "Unexpected month.");
+    static_assert(fromTimestamp32.getDay() == 11, "Unexpected day.");
+    static_assert(fromTimestamp32.getHour() == 12, "Unexpected hour.");
+    static_assert(fromTimestamp32.getMinute() == 21, "Unexpected minute.");
+    static_assert(fromTimestamp32.getSecond() == 13, "Unexpected second.");
+    constexpr DateTime fromTimestamp64 = Timestamp64(252455615999ull).toDateTime();
+    static_assert(fromTimestamp64.getYear() == 9999, "Unexpected year.");
+    static_assert(fromTimestamp64.getMonth() == 12, "Unexpected month.");
+    static_assert(fromTimestamp64.getDay() == 31, "Unexpected day.");
+    static_assert(fromTimestamp64.getHour() == 23, "Unexpected hour.");
+    static_assert(fromTimestamp64.getMinute() == 59, "Unexpected minute.");
+    static_assert(fromTimestamp64.getSecond() == 59, "Unexpected second.");
+
+    // The compile time table has to match the runtime conversion.
+    for (std::size_t i = 0; i < sizeof(cScheduleDateTimes)/sizeof(DateTime); ++i) {
+        EXPECT_EQ(Timestamp32(cScheduleDateTimes[i]).getValue(), cScheduleTimestamps[i].getValue());
+        EXPECT_EQ(cScheduleDateTimes[i], cScheduleTimestamps[i].toDateTime());
+    }
+}
+
+
+/// Test the timestamps with millisecond and nanosecond resolution.
+///
+TEST(TimestampTest, HighResolutionConstruction)
+{
+    const DateTime custom(2019, 4, 11, 12, 21, 13);
+    const TimestampMs64 timestampMs(custom);
+    EXPECT_EQ(608300473000ull, timestampMs.getValue());
+    EXPECT_EQ(0, timestampMs.getMillisecond());
+    EXPECT_EQ(1554985273, timestampMs.toUnixTimestamp());
+    EXPECT_EQ(608300473ull, timestampMs.toTimestamp64().getValue());
+    EXPECT_EQ(custom, timestampMs.toDateTime());
+    const TimestampNs64 timestampNs(custom);
+    EXPECT_EQ(608300473000000000ull, timestampNs.getValue());
+    EXPECT_EQ(0, timestampNs.getNanosecond());
+    EXPECT_EQ(1554985273, timestampNs.toUnixTimestamp());
+    EXPECT_EQ(608300473ull, timestampNs.toTimestamp64().getValue());
+    EXPECT_EQ(custom, timestampNs.toDateTime());
+    // From a timestamp with second resolution.
+    EXPECT_EQ(timestampMs, TimestampMs64(Timestamp64(custom)));
+    EXPECT_EQ(timestampNs, TimestampNs64(Timestamp64(custom)));
+    // The first value.
+    EXPECT_EQ(true, TimestampMs64().toDateTime().isFirst());
+    EXPECT_EQ(true, TimestampNs64().toDateTime().isFirst());
+    EXPECT_EQ(0, TimestampNs64().getValue());
+    // The last value of the nanosecond timestamp.
+    const TimestampNs64 lastNs(0xffffffffffffffffull);
+    EXPECT_EQ(DateTime(2584, 7, 20, 23, 34, 33), lastNs.toDateTime());
+    EXPECT_EQ(709551615u, lastNs.getNanosecond());
+}
+
+
+/// Test adding time to the high resolution timestamps.
+/// Sub-second parts are not part of the date/time, but are kept in the timestamp.
+///
+TEST(TimestampTest, HighResolutionAdd)
+{
+    const DateTime custom(2019, 4, 11, 12, 21, 13);
+    TimestampMs64 timestampMs(custom);
+    timestampMs.addMilliseconds(1500);
+    EXPECT_EQ(500, timestampMs.getMillisecond());
+    EXPECT_EQ(DateTime(2019, 4, 11, 12, 21, 14), timestampMs.toDateTime());
+    timestampMs.addSeconds(46);
+    EXPECT_EQ(500, timestampMs.getMillisecond());
+    EXPECT_EQ(DateTime(2019, 4, 11, 12, 22, 0), timestampMs.toDateTime());
+    timestampMs.addDays(20);
+    EXPECT_EQ(DateTime(2019, 5, 1, 12, 22, 0), timestampMs.toDateTime());
+    timestampMs.addMilliseconds(-501);
+    EXPECT_EQ(999, timestampMs.getMillisecond());
+    EXPECT_EQ(DateTime(2019, 5, 1, 12, 21, 59), timestampMs.toDateTime());
+
+    TimestampNs64 timestampNs(custom);
+    timestampNs.addNanoseconds(1);
+    EXPECT_EQ(1, timestampNs.getNanosecond());
+    EXPECT_EQ(custom, timestampNs.toDateTime());
+    timestampNs.addNanoseconds(999999999);
+    EXPECT_EQ(0, timestampNs.getNanosecond());
+    EXPECT_EQ(DateTime(2019, 4, 11, 12, 21, 14), timestampNs.toDateTime());
+    timestampNs.addSeconds(-14);
+    timestampNs.addDays(-11);
+    EXPECT_EQ(DateTime(2019, 3, 31, 12, 21, 0), timestampNs.toDateTime());
+}
+
+
+/// Test the differences between high resolution timestamps.
+///
+TEST(TimestampTest, HighResolutionDelta)
+{
+    const DateTime first;
+    const DateTime last(2019, 4, 11, 12, 21, 13);
+    EXPECT_EQ(608300473, TimestampMs64(first).secondsTo(TimestampMs64(last)));
+    EXPECT_EQ(608300473000, TimestampMs64(first).millisecondsTo(TimestampMs64(last)));
+    EXPECT_EQ(-608300473000, TimestampMs64(last).millisecondsTo(TimestampMs64(first)));
+    EXPECT_EQ(608300473, TimestampNs64(first).secondsTo(TimestampNs64(last)));
+    EXPECT_EQ(608300473000000000, TimestampNs64(first).nanosecondsTo(TimestampNs64(last)));
+    EXPECT_EQ(-608300473000000000, TimestampNs64(last).nanosecondsTo(TimestampNs64(first)));
+    // Seconds are truncated towards zero.
+    TimestampNs64 a(last);
+    TimestampNs64 b(last);
+    b.addNanoseconds(1999999999);
+    EXPECT_EQ(1, a.secondsTo(b));
+    EXPECT_EQ(-1, b.secondsTo(a));
+    EXPECT_EQ(1999999999, a.nanosecondsTo(b));
+}
+
+
+/// Test if the comparison of high resolution timestamps matches the order of the values.
+///
+TEST(TimestampTest, HighResolutionComparison)
+{
+    std::ranlux24_base engine(0x56); // Fixed value for the tests.
+    std::uniform_int_distribution<uint64_t> distribution;
+    std::uniform_int_distribution<uint64_t> smallDistribution(0, 2);
+    for (int i = 0; i < 10000; ++i) {
+        const uint64_t valueA = distribution(engine);
+        // Also test values which are very close.
+        const uint64_t valueB = ((i & 1) == 0) ? distribution(engine) : (valueA - 1 + smallDistribution(engine));
+        const TimestampNs64 a(valueA);
+        const TimestampNs64 b(valueB);
+        ASSERT_EQ(valueA == valueB, a == b);
+        ASSERT_EQ(valueA != valueB, a != b);
+        ASSERT_EQ(valueA < valueB, a < b);
+        ASSERT_EQ(valueA <= valueB, a <= b);
+        ASSERT_EQ(valueA > valueB, a > b);
+        ASSERT_EQ(valueA >= valueB, a >= b);
+        // The order has to match the date/time order.
+        if (a < b) {
+            ASSERT_LE(a.toDateTime(), b.toDateTime());
+        }
+    }
+}
+
+
+/// Test the conversion of random high resolution timestamps to date/time.
+///
+TEST(TimestampTest, HighResolutionToDateTime)
+{
+    static_assert(sizeof(std::time_t) >= 8, "This test requires 64bit time_t.");
+    std::ranlux24_base engine(0x56); // Fixed value for the tests.
+    std::uniform_int_distribution<uint64_t> distribution;
+    for (int i = 0; i < 10000; ++i) {
+        const TimestampNs64 timestampNs(distribution(engine));
+        ASSERT_NO_FATAL_FAILURE(expectDateTimeFromUnix(timestampNs.toTimestamp64()));
+        ASSERT_EQ(timestampNs.toTimestamp64().toDateTime(), timestampNs.toDateTime());
+        ASSERT_EQ(timestampNs.getValue() % 1000000000ull, timestampNs.getNanosecond());
+        const TimestampMs64 timestampMs(timestampNs.getValue() / 1000000ull);
+        ASSERT_EQ(timestampNs.toDateTime(), timestampMs.toDateTime());
+        ASSERT_EQ(timestampNs.toUnixTimestamp(), timestampMs.toUnixTimestamp());
+        ASSERT_EQ(timestampNs.getNanosecond() / 1000000u, timestampMs.getMillisecond());
+    }
+}
+
+
 #pragma clang diagnostic pop
 